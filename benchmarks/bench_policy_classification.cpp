@@ -0,0 +1,74 @@
+// Compares the array-of-structs policy loop (vector<ProcessInfo>, one
+// std::string per row) with PolicyClassifier over ProcessSnapshot columns.
+// Build: g++ -O2 -std=c++17 -Isrc/core -Isrc/utils benchmarks/bench_policy_classification.cpp
+//            src/core/PolicyClassifier.cpp src/core/ProcessSnapshot.cpp
+// Add -mavx2 to exercise the AVX2 path.
+#include "PolicyClassifier.h"
+#include "ProcessSnapshot.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    int rounds = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    const double cpu_threshold = 50.0;
+    const long memory_threshold = 2048L * 1024;
+
+    std::mt19937 rng(42);
+    std::exponential_distribution<double> cpu(1.0 / 8.0);
+    std::uniform_int_distribution<long> memory(1024, 4L * 1024 * 1024);
+    std::vector<ProcessInfo> rows;
+    ProcessSnapshot::Builder builder;
+    builder.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ProcessInfo info;
+        info.pid = static_cast<int>(i + 1);
+        info.start_time = i;
+        info.name = "process-" + std::to_string(i);
+        info.cpu_usage = cpu(rng);
+        info.memory_usage = memory(rng);
+        info.cpu_delay = 0.0;
+        info.io_delay = 0.0;
+        info.wait_rate = 0.0;
+        info.sched_latency_us = 0.0;
+        info.has_schedstat = false;
+        info.flags = 0;
+        info.process_class = ProcessClass::SESSION;
+        info.group_id = 0;
+        rows.push_back(info);
+        builder.add(info);
+    }
+    ProcessSnapshot snapshot = builder.build(std::chrono::steady_clock::now());
+
+    size_t aos_hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<int> selected;
+        for (const auto& proc : rows) {
+            if (proc.cpu_usage > cpu_threshold || proc.memory_usage > memory_threshold) selected.push_back(proc.pid);
+        }
+        aos_hits += selected.size();
+    }
+    double aos = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    size_t soa_hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        DecisionBitmap selected = PolicyClassifier::above(snapshot.cpuUsage(), cpu_threshold) |
+                                  PolicyClassifier::above(snapshot.memoryUsage(), memory_threshold);
+        soa_hits += selected.count();
+    }
+    double soa = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    if (aos_hits != soa_hits) {
+        std::cerr << "Mismatch: AoS selected " << aos_hits << ", SoA selected " << soa_hits << "\n";
+        return 1;
+    }
+    std::cout << count << " processes, " << aos_hits / rounds << " selected per pass\n";
+    std::cout << "AoS loop:        " << aos << " us/pass\n";
+    std::cout << "SoA + bitmap:    " << soa << " us/pass (" << aos / soa << "x)\n";
+    return 0;
+}
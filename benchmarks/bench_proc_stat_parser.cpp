@@ -0,0 +1,89 @@
+// Compares the istringstream-based /proc/[pid]/stat reader that
+// ProcessManager::calculateCPUUsage used to ship with against ProcStatParser.
+// Build: g++ -O2 -std=c++17 -Isrc/utils -Isrc/logging
+//            benchmarks/bench_proc_stat_parser.cpp src/utils/ProcStatParser.cpp
+#include "ProcStatParser.h"
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static double legacyCalculateCPUUsage(int pid) {
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    if (!stat.is_open()) return 0.0;
+    std::string line;
+    std::getline(stat, line);
+    std::istringstream iss(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (iss >> token) tokens.push_back(token);
+    long utime = std::stol(tokens[13]);
+    long stime = std::stol(tokens[14]);
+    stat.close();
+    return (utime + stime) / 100.0;
+}
+
+static double parserCalculateCPUUsage(int pid) {
+    ProcStat stat;
+    if (!ProcStatParser::read(pid, stat)) return 0.0;
+    return (stat.utime + stat.stime) / 100.0;
+}
+
+static std::vector<int> listPids() {
+    std::vector<int> pids;
+    DIR* dir = opendir("/proc");
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] >= '0' && ent->d_name[0] <= '9') pids.push_back(std::atoi(ent->d_name));
+    }
+    closedir(dir);
+    return pids;
+}
+
+template <typename F>
+static void run(const char* label, const std::vector<int>& pids, int rounds, F fn) {
+    double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int pid : pids) sink += fn(pid);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << ": " << elapsed / (rounds * pids.size()) << " ns/pid (checksum " << sink << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = (argc > 1) ? std::atoi(argv[1]) : 50;
+    auto pids = listPids();
+    std::cout << "PIDs: " << pids.size() << ", rounds: " << rounds << "\n";
+    run("istringstream", pids, rounds, legacyCalculateCPUUsage);
+    run("ProcStatParser", pids, rounds, parserCalculateCPUUsage);
+
+    // Parse-only comparison on a fixed line isolates the tokenizer cost.
+    const std::string line = "4242 (my proc) S 1 4242 4242 0 -1 4194560 120 0 0 0 350 125 0 0 20 0 3 0 98765 "
+                             "10485760 512 18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 5 0 0 0 0 0";
+    const int iterations = 1000000;
+    long long sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token) tokens.push_back(token);
+        sink += std::stol(tokens[13]) + std::stol(tokens[14]);
+    }
+    auto legacy = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        ProcStat stat;
+        ProcStatParser::parse(line.data(), line.size(), stat);
+        sink += stat.utime + stat.stime;
+    }
+    auto parsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "parse only: istringstream " << legacy / iterations << " ns, ProcStatParser "
+              << parsed / iterations << " ns (checksum " << sink << ")\n";
+    return 0;
+}
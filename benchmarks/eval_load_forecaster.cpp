@@ -0,0 +1,165 @@
+// Offline evaluation of LoadForecaster against recorded load traces. For each
+// series it replays the trace through the forecaster and scores the
+// forecast made at sample i against the value observed at sample i + h,
+// next to the naive "load stays where it is" forecast.
+// Build: g++ -O2 -std=c++17 -pthread -Isrc/core -Isrc/utils -Isrc/logging
+//            benchmarks/eval_load_forecaster.cpp src/core/LoadForecaster.cpp
+//            src/core/CpuStatSampler.cpp src/core/PressureMonitor.cpp src/logging/Logger.cpp
+// Usage: eval_load_forecaster [trace|-] [alpha] [beta]   score a trace ('-' or none: synthetic)
+//        eval_load_forecaster --record <trace> [seconds] [rate_hz]
+// Trace lines are "seconds cpu_busy% [cpu_stall%]"; '#' starts a comment.
+#include "LoadForecaster.h"
+#include "CpuStatSampler.h"
+#include "PressureMonitor.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TracePoint {
+    double time;
+    double cpu;
+    double stall; // NAN when the trace has no PSI column
+};
+
+static bool loadTrace(const char* path, std::vector<TracePoint>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        TracePoint point = {0.0, 0.0, NAN};
+        if (!(fields >> point.time >> point.cpu)) continue;
+        fields >> point.stall;
+        out.push_back(point);
+    }
+    return true;
+}
+
+// Idle, a ramp into saturation, a plateau, sudden spikes and noise.
+static std::vector<TracePoint> syntheticTrace() {
+    std::vector<TracePoint> trace;
+    std::mt19937 rng(1);
+    std::normal_distribution<double> noise(0.0, 3.0);
+    for (int i = 0; i < 3000; ++i) {
+        double t = i * 0.05;
+        double base = 10.0;
+        if (t > 30 && t <= 60) base = 10.0 + (t - 30) * 2.5;
+        if (t > 60 && t <= 90) base = 85.0;
+        if (t > 90) base = 30.0 + 20.0 * std::sin(t / 3.0);
+        if (i % 400 > 390) base += 40.0;
+        double cpu = std::max(0.0, std::min(100.0, base + noise(rng)));
+        trace.push_back({t, cpu, std::max(0.0, cpu - 70.0) / 3.0});
+    }
+    return trace;
+}
+
+static int record(const char* path, double seconds, int rate_hz) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    CpuStatSampler cpu;
+    PressureMonitor pressure;
+    CpuStatSnapshot snapshot;
+    PressureSnapshot psi;
+    cpu.sample(snapshot); // Baseline
+    unsigned long long last_stall = pressure.read(psi) ? psi.cpu.some.total_us : 0;
+    auto start = std::chrono::steady_clock::now();
+    auto previous = start;
+    out << "# seconds cpu_busy% cpu_stall%\n";
+    for (auto next = start; next - start < std::chrono::duration<double>(seconds);) {
+        next += std::chrono::microseconds(1000000 / rate_hz);
+        std::this_thread::sleep_until(next);
+        auto now = std::chrono::steady_clock::now();
+        if (!cpu.sample(snapshot)) return 1;
+        double t = std::chrono::duration<double>(now - start).count();
+        out << t << " " << snapshot.total.busy;
+        if (pressure.read(psi)) {
+            double elapsed = std::chrono::duration<double>(now - previous).count();
+            out << " " << 100.0 * (psi.cpu.some.total_us - last_stall) / (elapsed * 1e6);
+            last_stall = psi.cpu.some.total_us;
+        }
+        out << "\n";
+        previous = now;
+    }
+    std::cout << "Recorded " << seconds << "s at " << rate_hz << " Hz to " << path << "\n";
+    return 0;
+}
+
+struct Score {
+    double holt_abs = 0.0;
+    double holt_sq = 0.0;
+    double naive_abs = 0.0;
+    double naive_sq = 0.0;
+    double confidence = 0.0;
+    double confident_abs = 0.0; // Holt error where confidence >= 0.5
+    size_t confident = 0;
+    size_t count = 0;
+};
+
+static void evaluate(const char* label, const std::vector<TracePoint>& trace, bool stall, size_t horizon,
+                     double alpha, double beta) {
+    LoadForecaster forecaster(alpha, beta);
+    Score score;
+    for (size_t i = 0; i + horizon < trace.size(); ++i) {
+        double value = stall ? trace[i].stall : trace[i].cpu;
+        forecaster.update(value, trace[i].time);
+        if (forecaster.samples() < LoadForecaster::WARMUP_SAMPLES + 1) continue;
+        double actual = stall ? trace[i + horizon].stall : trace[i + horizon].cpu;
+        double holt = forecaster.forecast(trace[i + horizon].time - trace[i].time) - actual;
+        double naive = value - actual;
+        score.holt_abs += std::fabs(holt);
+        score.holt_sq += holt * holt;
+        score.naive_abs += std::fabs(naive);
+        score.naive_sq += naive * naive;
+        score.confidence += forecaster.confidence();
+        if (forecaster.confidence() >= 0.5) {
+            score.confident_abs += std::fabs(holt);
+            ++score.confident;
+        }
+        ++score.count;
+    }
+    if (!score.count) return;
+    double n = static_cast<double>(score.count);
+    std::cout << label << " h=" << horizon << ": Holt MAE " << score.holt_abs / n << " RMSE "
+              << std::sqrt(score.holt_sq / n) << " | naive MAE " << score.naive_abs / n << " RMSE "
+              << std::sqrt(score.naive_sq / n) << " | mean confidence " << score.confidence / n;
+    if (score.confident) std::cout << ", MAE when confident " << score.confident_abs / score.confident;
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        double seconds = (argc > 3) ? std::atof(argv[3]) : 60.0;
+        int rate = (argc > 4) ? std::atoi(argv[4]) : 10;
+        return record(argv[2], seconds, rate > 0 ? rate : 10);
+    }
+    std::vector<TracePoint> trace;
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        if (!loadTrace(argv[1], trace)) {
+            std::cerr << "Cannot read " << argv[1] << "\n";
+            return 1;
+        }
+    } else {
+        trace = syntheticTrace();
+    }
+    double alpha = (argc > 2) ? std::atof(argv[2]) : 0.3;
+    double beta = (argc > 3) ? std::atof(argv[3]) : 0.05;
+    bool has_stall = !trace.empty() && !std::isnan(trace[0].stall);
+    std::cout << trace.size() << " samples, alpha " << alpha << ", beta " << beta << "\n";
+    for (size_t horizon : {1, 3, 5}) {
+        evaluate("cpu  ", trace, false, horizon, alpha, beta);
+        if (has_stall) evaluate("stall", trace, true, horizon, alpha, beta);
+    }
+    return 0;
+}
@@ -13,6 +13,35 @@ struct SchedulerConfig {
     int cgroup_cpu_shares;
     int cgroup_memory_limit_mb;
     int ipc_queue_size;
+    bool use_proc_events;       // Track fork/exec/exit through the proc connector
+    int reconcile_interval_ms;  // Full /proc rescan period when events are enabled
+    std::string proc_reader;    // "io_uring", "syscall" or "taskstats"
+    bool sample_process_io;     // Also read /proc/[pid]/io each scan
+    std::string thread_policy;  // "process", "hot_threads" or "all_threads"
+    double hot_thread_threshold; // Thread CPU% that makes a thread hot
+    int sampling_warm_interval; // Cycles between reads of quiet processes
+    int sampling_idle_interval; // Cycles between reads of processes whose counters stopped
+    double sampling_hot_threshold; // Process CPU% that restores per-cycle reads
+    std::vector<std::string> excluded_processes; // comm names never touched by policies
+    int psi_window_ms;          // PSI trigger window (500-10000)
+    int psi_cpu_stall_ms;       // "some" stall per window that wakes the scheduler, 0 = off
+    int psi_memory_stall_ms;
+    int psi_io_stall_ms;
+    int calm_interval_ms;       // Longest sleep between cycles while PSI triggers are armed
+    int sampler_rate_hz;        // System snapshot rate of the background sampler (1-1000)
+    int foreground_wait_target_ms; // Run-queue wait per second the busiest foreground process may see (1-1000)
+    std::string cpufreq_governor;  // scaling_governor for every policy, "" = as found at startup
+    std::string cpufreq_energy_preference; // energy_performance_preference, "" = as found
+    int cpufreq_min_khz;        // scaling_min_freq, 0 = as found
+    int cpufreq_max_khz;        // scaling_max_freq, 0 = as found
+    std::string reclaim_advice; // "off", "cold" or "pageout" for cold background processes
+    double reclaim_trigger_percent; // Used memory % above which reclaim runs
+    int reclaim_budget_mb;      // Most memory advised per scheduling cycle
+    int proactive_reclaim_mb;   // memory.reclaim request per background cgroup and cycle at no pressure, 0 = off
+    double reclaim_headroom_percent; // MemAvailable % below which background cgroups are reclaimed
+    int memory_rollups_per_cycle; // smaps_rollup reads per cycle (PSS, swap)
+    int working_set_window_ms;  // Idle page tracking window, 0 = no working-set estimates
+    int working_set_processes_per_cycle; // Working-set windows opened per cycle
 };
 
 #endif
@@ -0,0 +1,184 @@
+#include "CgroupReclaimer.h"
+#include "PressureMonitor.h"
+#include "FileUtils.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+const double CgroupReclaimer::REFAULT_BACKOFF_RATIO = 0.3;
+const double CgroupReclaimer::MIN_SCALE = 1.0 / 16.0;
+
+namespace {
+
+const double MAX_PRESSURE_FACTOR = 4.0; // Reached at 30% memory "some" stall
+const double SCALE_RECOVERY = 0.125;    // Added back per cycle without refaults
+const size_t MAX_SHARE_DIVISOR = 8;     // Never ask a cgroup for more than 1/8 of its usage per cycle
+
+const size_t PAGE_SIZE_BYTES = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+bool readNumber(const std::string& path, unsigned long long& out) {
+    std::string text;
+    if (!FileUtils::readAll(path, text) || text.empty()) return false;
+    out = strtoull(text.c_str(), nullptr, 10);
+    return true;
+}
+
+// Sums "key value" lines of a memory.stat or vmstat image whose key starts
+// with prefix, except those listed in skip.
+unsigned long long sumFields(const std::string& text, const char* prefix, const char* skip) {
+    unsigned long long total = 0;
+    size_t prefix_len = strlen(prefix);
+    for (size_t line = 0; line < text.size();) {
+        size_t eol = text.find('\n', line);
+        if (eol == std::string::npos) eol = text.size();
+        size_t space = text.find(' ', line);
+        if (space < eol && text.compare(line, prefix_len, prefix) == 0 &&
+            (!skip || text.compare(line, space - line, skip) != 0)) {
+            total += strtoull(text.c_str() + space + 1, nullptr, 10);
+        }
+        line = eol + 1;
+    }
+    return total;
+}
+
+}
+
+CgroupReclaimer::CgroupReclaimer(const std::string& cgroup_root, const std::string& proc_root)
+    : cgroupRoot(cgroup_root), procRoot(proc_root), lastDirectScans(0), haveDirectScans(false), warnedUnsupported(false) {}
+
+// workingset_refault_anon and _file since Linux 5.9, workingset_refault before.
+bool CgroupReclaimer::parseRefaults(const char* buf, size_t len, unsigned long long& out) {
+    std::string text(buf, len);
+    out = sumFields(text, "workingset_refault", nullptr);
+    return text.find("workingset_refault") != std::string::npos;
+}
+
+// A background tty job shares its session scope with the foreground shell
+// and whatever that runs, so a cgroup qualifies only when every process in
+// it is BACKGROUND; reclaiming from a mixed one takes foreground pages too.
+size_t CgroupReclaimer::update(const SchedulerConfig& config, const ProcessSnapshot& snapshot, double available_percent) {
+    std::vector<const std::string*> order;
+    std::unordered_map<const std::string*, bool> eligible; // Interned: one pointer per path
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        const auto& identity = snapshot.identities()[i];
+        if (!identity || !identity->cgroup) continue;
+        const std::string* cgroup = identity->cgroup.get();
+        bool background = snapshot.classes()[i] == ProcessClass::BACKGROUND;
+        auto inserted = eligible.emplace(cgroup, background);
+        if (inserted.second) {
+            order.push_back(cgroup);
+        } else {
+            inserted.first->second = inserted.first->second && background;
+        }
+    }
+    std::vector<std::string> cgroups;
+    for (const std::string* cgroup : order) {
+        if (eligible[cgroup] && !cgroup->empty() && *cgroup != "/") cgroups.push_back(*cgroup);
+    }
+    return step(cgroups, config, available_percent);
+}
+
+// Cgroups are read every cycle so the refault baseline stays current, but
+// only asked for memory while the headroom is short or direct reclaim began.
+size_t CgroupReclaimer::step(const std::vector<std::string>& cgroups, const SchedulerConfig& config,
+                             double available_percent) {
+    for (auto& entry : states) entry.second.seen = false;
+    bool direct = directReclaimStarted();
+    bool active = config.proactive_reclaim_mb > 0 && (available_percent < config.reclaim_headroom_percent || direct);
+    double psi = active ? memoryPressure() : 0.0;
+    double factor = std::min(MAX_PRESSURE_FACTOR, 1.0 + psi / 10.0) * (direct ? 2.0 : 1.0);
+    size_t base_bytes = active ? static_cast<size_t>(config.proactive_reclaim_mb * factor * 1024 * 1024) : 0;
+
+    size_t total = 0;
+    for (const std::string& cgroup : cgroups) {
+        auto inserted = states.emplace(cgroup, CgroupReclaimState());
+        CgroupReclaimState& state = inserted.first->second;
+        if (inserted.second) state.scale = 1.0;
+        state.seen = true;
+        total += reclaimFrom(cgroup, state, base_bytes);
+    }
+    for (auto it = states.begin(); it != states.end();) {
+        it = it->second.seen ? std::next(it) : states.erase(it);
+    }
+    if (total > 0) {
+        Logger::log("Proactively reclaimed " + std::to_string(total / 1024) + " KB from " +
+                    std::to_string(cgroups.size()) + " background cgroups (available " +
+                    std::to_string(available_percent) + "%, memory PSI some " + std::to_string(psi) + "%" +
+                    (direct ? ", direct reclaim seen" : "") + ")");
+    }
+    return total;
+}
+
+size_t CgroupReclaimer::reclaimFrom(const std::string& cgroup, CgroupReclaimState& state, size_t base_bytes) {
+    std::string dir = cgroupRoot + cgroup;
+    std::string stat;
+    unsigned long long refaults = 0;
+    if (FileUtils::readAll(dir + "/memory.stat", stat)) parseRefaults(stat.data(), stat.size(), refaults);
+    if (state.reclaimed > 0) {
+        unsigned long long refaulted = refaults - std::min(refaults, state.refaults);
+        double ratio = static_cast<double>(refaulted * PAGE_SIZE_BYTES) / state.reclaimed;
+        if (ratio > REFAULT_BACKOFF_RATIO) {
+            state.scale = std::max(MIN_SCALE, state.scale / 2.0);
+            Logger::log("Backing off reclaim of " + cgroup + ": " + std::to_string(refaulted) +
+                        " pages refaulted, scale " + std::to_string(state.scale));
+        } else {
+            state.scale = std::min(1.0, state.scale + SCALE_RECOVERY);
+        }
+    }
+    state.refaults = refaults;
+    state.reclaimed = 0;
+    if (base_bytes == 0) return 0;
+
+    unsigned long long before = 0;
+    if (!readNumber(dir + "/memory.current", before)) return 0;
+    size_t amount = std::min(static_cast<size_t>(base_bytes * state.scale), static_cast<size_t>(before / MAX_SHARE_DIVISOR));
+    amount -= amount % PAGE_SIZE_BYTES;
+    if (amount == 0) return 0;
+
+    int fd = open((dir + "/memory.reclaim").c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd == -1) {
+        if (errno == ENOENT && !warnedUnsupported) {
+            Logger::log("memory.reclaim unavailable (needs Linux 5.19), no proactive reclaim");
+            warnedUnsupported = true;
+        }
+        return 0;
+    }
+    std::string request = std::to_string(amount);
+    // EAGAIN means the cgroup gave up less than asked; memory.current says how much.
+    bool complete = write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size());
+    close(fd);
+    unsigned long long after = before;
+    readNumber(dir + "/memory.current", after);
+    state.reclaimed = complete ? amount : static_cast<size_t>(before - std::min(before, after));
+    return state.reclaimed;
+}
+
+const CgroupReclaimState* CgroupReclaimer::state(const std::string& cgroup) const {
+    auto it = states.find(cgroup);
+    return (it == states.end()) ? nullptr : &it->second;
+}
+
+double CgroupReclaimer::memoryPressure() const {
+    std::string text;
+    PressureStats stats;
+    if (!FileUtils::readAll(procRoot + "/pressure/memory", text) || !PressureMonitor::parse(text.data(), text.size(), stats)) {
+        return 0.0;
+    }
+    return stats.some.avg10;
+}
+
+// pgscan_direct (per zone before Linux 4.8) only moves when an allocating
+// task had to reclaim for itself, which is what this controller prevents.
+bool CgroupReclaimer::directReclaimStarted() {
+    std::string text;
+    if (!FileUtils::readAll(procRoot + "/vmstat", text)) return false;
+    unsigned long long scans = sumFields(text, "pgscan_direct", "pgscan_direct_throttle");
+    bool started = haveDirectScans && scans > lastDirectScans;
+    lastDirectScans = scans;
+    haveDirectScans = true;
+    return started;
+}
@@ -0,0 +1,53 @@
+#ifndef CGROUP_RECLAIMER_H
+#define CGROUP_RECLAIMER_H
+
+#include "types.h"
+#include "ProcessSnapshot.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+// One background cgroup's controller state between cycles.
+struct CgroupReclaimState {
+    unsigned long long refaults;   // workingset_refault_* pages at the last cycle
+    unsigned long long reclaimed;  // Bytes reclaimed at the last cycle
+    double scale;                  // Back-off multiplier, 1/16..1
+    bool seen;                     // Still has background processes this cycle
+};
+
+// Proactive reclaim: while MemAvailable is under the headroom target, or the
+// system has started direct reclaim, each background cgroup is asked to give
+// up memory through cgroup v2 memory.reclaim (Linux 5.19+), so foreground
+// allocations find free pages instead of reclaiming for themselves. The
+// amount grows with memory PSI "some" and halves for a cgroup whose
+// refaults show the last reclaim cut into its working set.
+class CgroupReclaimer {
+public:
+    static const double REFAULT_BACKOFF_RATIO; // Refaulted / reclaimed that halves a cgroup's amount
+    static const double MIN_SCALE;
+
+    explicit CgroupReclaimer(const std::string& cgroup_root = "/sys/fs/cgroup", const std::string& proc_root = "/proc");
+
+    // Runs one cycle over the cgroups whose processes are all BACKGROUND.
+    size_t update(const SchedulerConfig& config, const ProcessSnapshot& snapshot, double available_percent);
+    // One cycle over cgroup paths relative to the root; returns bytes reclaimed.
+    size_t step(const std::vector<std::string>& cgroups, const SchedulerConfig& config, double available_percent);
+
+    const CgroupReclaimState* state(const std::string& cgroup) const;
+    static bool parseRefaults(const char* buf, size_t len, unsigned long long& out);
+
+private:
+    size_t reclaimFrom(const std::string& cgroup, CgroupReclaimState& state, size_t base_bytes);
+    double memoryPressure() const;
+    bool directReclaimStarted();
+
+    std::string cgroupRoot;
+    std::string procRoot;
+    std::unordered_map<std::string, CgroupReclaimState> states;
+    unsigned long long lastDirectScans;
+    bool haveDirectScans;
+    bool warnedUnsupported;
+};
+
+#endif
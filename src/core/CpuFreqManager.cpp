@@ -0,0 +1,156 @@
+#include "CpuFreqManager.h"
+#include "Logger.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char* const CpuFreqManager::DEFAULT_ROOT = "/sys/devices/system/cpu";
+
+namespace {
+
+const char* const FILES[] = {"scaling_governor", "energy_performance_preference", "scaling_min_freq",
+                             "scaling_max_freq"};
+// Values the driver accepts, where it says; nullptr for the frequencies,
+// which the kernel clamps to cpuinfo_{min,max}_freq itself.
+const char* const AVAILABLE[] = {"scaling_available_governors", "energy_performance_available_preferences",
+                                 nullptr, nullptr};
+
+bool readValue(const std::string& path, std::string& out) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return false;
+    char buf[512];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n < 0) return false;
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) --n;
+    out.assign(buf, static_cast<size_t>(n));
+    return true;
+}
+
+// sysfs takes the value in a single write(); O_TRUNC only matters for the
+// regular files of a test tree.
+bool writeValue(const std::string& path, const std::string& value) {
+    int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (fd == -1) return false;
+    ssize_t n = write(fd, value.data(), value.size());
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return n == static_cast<ssize_t>(value.size());
+}
+
+// A missing list means the driver does not advertise one; let the write decide.
+bool isListed(const std::string& path, const std::string& value) {
+    std::string list;
+    if (!readValue(path, list)) return true;
+    for (size_t start = 0; start < list.size();) {
+        size_t end = list.find(' ', start);
+        if (end == std::string::npos) end = list.size();
+        if (list.compare(start, end - start, value) == 0) return true;
+        start = end + 1;
+    }
+    return false;
+}
+
+std::string frequency(int khz) {
+    return khz > 0 ? std::to_string(khz) : std::string();
+}
+
+}
+
+// CPUs that share a policy (cpuN/cpufreq -> ../cpufreq/policyM) are
+// resolved to one entry so each policy is read and written once. Every
+// attribute is read up front: a value first seen at the first write may
+// already be another mode's.
+CpuFreqManager::CpuFreqManager(const std::string& sysfs_root) : failedWrites(0) {
+    DIR* dir = opendir(sysfs_root.c_str());
+    if (dir) {
+        std::set<std::string> seen;
+        while (dirent* entry = readdir(dir)) {
+            const char* name = entry->d_name;
+            if (strncmp(name, "cpu", 3) != 0 || name[3] < '0' || name[3] > '9') continue;
+            char resolved[PATH_MAX];
+            if (!realpath((sysfs_root + "/" + name + "/cpufreq").c_str(), resolved)) continue;
+            if (!seen.insert(resolved).second) continue;
+            Policy policy;
+            policy.dir = resolved;
+            for (int attribute = 0; attribute < ATTRIBUTE_COUNT; ++attribute) {
+                policy.saved[attribute] = readValue(policy.dir + "/" + FILES[attribute], policy.original[attribute]);
+            }
+            policies.push_back(policy);
+        }
+        closedir(dir);
+    }
+    if (policies.empty()) Logger::log("No cpufreq policies under " + sysfs_root + "; CPU frequency left alone");
+}
+
+CpuFreqManager::~CpuFreqManager() {
+    restore();
+}
+
+size_t CpuFreqManager::apply(const SchedulerConfig& config) {
+    const std::string wanted[ATTRIBUTE_COUNT] = {config.cpufreq_governor, config.cpufreq_energy_preference,
+                                                 frequency(config.cpufreq_min_khz), frequency(config.cpufreq_max_khz)};
+    failedWrites = 0;
+    size_t written = 0;
+    for (const Policy& policy : policies) written += applyTo(policy, wanted);
+    if (written || failedWrites) {
+        Logger::log("CPU frequency: " + std::to_string(written) + " settings written across " +
+                    std::to_string(policies.size()) + " policies, " + std::to_string(failedWrites) + " refused");
+    }
+    return written;
+}
+
+size_t CpuFreqManager::restore() {
+    const std::string unset[ATTRIBUTE_COUNT];
+    failedWrites = 0;
+    size_t written = 0;
+    for (const Policy& policy : policies) written += applyTo(policy, unset);
+    if (written) Logger::log("Restored " + std::to_string(written) + " original CPU frequency settings");
+    return written;
+}
+
+// Unset attributes go back to the value found at construction. The
+// governor goes first because the pstate drivers only accept some
+// preferences under some governors (only "performance" under performance).
+size_t CpuFreqManager::applyTo(const Policy& policy, const std::string (&wanted)[ATTRIBUTE_COUNT]) {
+    std::string target[ATTRIBUTE_COUNT];
+    for (int attribute = 0; attribute < ATTRIBUTE_COUNT; ++attribute) {
+        target[attribute] = !wanted[attribute].empty() ? wanted[attribute]
+                            : policy.saved[attribute]  ? policy.original[attribute]
+                                                       : std::string();
+    }
+    size_t written = 0;
+    written += set(policy, GOVERNOR, target[GOVERNOR]);
+    written += set(policy, ENERGY_PREFERENCE, target[ENERGY_PREFERENCE]);
+    // A floor above the current ceiling is refused, so raise the ceiling first then.
+    std::string current_max;
+    bool max_first = !target[MIN_FREQ].empty() && readValue(policy.dir + "/" + FILES[MAX_FREQ], current_max) &&
+                     strtoull(target[MIN_FREQ].c_str(), nullptr, 10) > strtoull(current_max.c_str(), nullptr, 10);
+    if (max_first) written += set(policy, MAX_FREQ, target[MAX_FREQ]);
+    written += set(policy, MIN_FREQ, target[MIN_FREQ]);
+    if (!max_first) written += set(policy, MAX_FREQ, target[MAX_FREQ]);
+    return written;
+}
+
+bool CpuFreqManager::set(const Policy& policy, Attribute attribute, const std::string& wanted) {
+    if (wanted.empty()) return false;
+    std::string path = policy.dir + "/" + FILES[attribute];
+    std::string current;
+    if (!readValue(path, current)) return false; // Not provided by this driver
+    if (current == wanted) return false;
+    if (AVAILABLE[attribute] && !isListed(policy.dir + "/" + AVAILABLE[attribute], wanted)) {
+        if (failedWrites++ == 0) Logger::log(path + " does not offer \"" + wanted + "\"");
+        return false;
+    }
+    if (!writeValue(path, wanted)) {
+        if (failedWrites++ == 0) Logger::log("Could not write " + path + ": " + strerror(errno));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef CPU_FREQ_MANAGER_H
+#define CPU_FREQ_MANAGER_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Per-mode cpufreq settings: scaling governor, energy-performance preference
+// (intel_pstate / amd-pstate in active mode only) and the min/max frequency
+// limits of every cpufreq policy under the sysfs root. A file is written only
+// when its current value differs. The values found at construction are
+// kept, restored when a mode leaves the setting unset, and by restore() on
+// exit.
+class CpuFreqManager {
+public:
+    static const char* const DEFAULT_ROOT; // /sys/devices/system/cpu
+
+    explicit CpuFreqManager(const std::string& sysfs_root = DEFAULT_ROOT);
+    ~CpuFreqManager();
+    CpuFreqManager(const CpuFreqManager&) = delete;
+    CpuFreqManager& operator=(const CpuFreqManager&) = delete;
+
+    bool isSupported() const { return !policies.empty(); }
+    size_t policyCount() const { return policies.size(); }
+
+    // Returns the number of files written.
+    size_t apply(const SchedulerConfig& config);
+    size_t restore();
+
+private:
+    enum Attribute { GOVERNOR, ENERGY_PREFERENCE, MIN_FREQ, MAX_FREQ, ATTRIBUTE_COUNT };
+
+    struct Policy {
+        std::string dir;                       // Resolved cpuN/cpufreq
+        std::string original[ATTRIBUTE_COUNT]; // As found at construction
+        bool saved[ATTRIBUTE_COUNT];           // false where the driver has no such file
+    };
+
+    size_t applyTo(const Policy& policy, const std::string (&wanted)[ATTRIBUTE_COUNT]);
+    bool set(const Policy& policy, Attribute attribute, const std::string& wanted);
+
+    std::vector<Policy> policies;
+    size_t failedWrites;                       // Since the last apply()/restore()
+};
+
+#endif
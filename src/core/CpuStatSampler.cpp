@@ -0,0 +1,146 @@
+#include "CpuStatSampler.h"
+#include "Logger.h"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+unsigned long long parseNumber(const char*& p, const char* end) {
+    while (p < end && *p == ' ') ++p;
+    unsigned long long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+    return value;
+}
+
+bool startsWith(const char* line, const char* eol, const char* prefix, size_t len) {
+    return static_cast<size_t>(eol - line) > len && memcmp(line, prefix, len) == 0;
+}
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+CpuStatSampler::CpuStatSampler()
+    : buffer(8192), previousTotal(), previousCtxt(0), previousForks(0), hasPrevious(false), lastSampleTime(0.0) {
+    stat_fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    if (stat_fd == -1) Logger::log("Failed to open /proc/stat");
+}
+
+CpuStatSampler::~CpuStatSampler() {
+    if (stat_fd != -1) close(stat_fd);
+}
+
+bool CpuStatSampler::sample(CpuStatSnapshot& out) {
+    if (stat_fd == -1) return false;
+    size_t len = 0;
+    while (true) {
+        ssize_t n = pread(stat_fd, buffer.data() + len, buffer.size() - len, static_cast<off_t>(len));
+        if (n < 0) return false;
+        if (n == 0) break;
+        len += static_cast<size_t>(n);
+        if (len == buffer.size()) buffer.resize(buffer.size() * 2);
+    }
+    double now = nowSeconds();
+    double interval = hasPrevious ? now - lastSampleTime : 0.0;
+    lastSampleTime = now;
+    return update(buffer.data(), len, interval, out);
+}
+
+bool CpuStatSampler::update(const char* buf, size_t len, double interval_seconds, CpuStatSnapshot& out) {
+    const char* end = buf + len;
+    CpuTimes total = CpuTimes();
+    bool have_total = false;
+    unsigned long long ctxt = 0, forks = 0;
+    out.procs_running = 0;
+    out.procs_blocked = 0;
+    currentCores.assign(currentCores.size(), CpuTimes());
+    coreSeen.assign(currentCores.size(), 0);
+
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        const char* p;
+        if (startsWith(line, eol, "cpu ", 4)) {
+            have_total = parseCpuLine(line + 4, eol, total);
+        } else if (startsWith(line, eol, "cpu", 3)) {
+            p = line + 3;
+            size_t cpu = static_cast<size_t>(parseNumber(p, eol));
+            if (cpu >= currentCores.size()) currentCores.resize(cpu + 1, CpuTimes());
+            if (cpu >= coreSeen.size()) coreSeen.resize(cpu + 1, 0);
+            coreSeen[cpu] = parseCpuLine(p, eol, currentCores[cpu]);
+        } else if (startsWith(line, eol, "ctxt ", 5)) {
+            p = line + 5;
+            ctxt = parseNumber(p, eol);
+        } else if (startsWith(line, eol, "processes ", 10)) {
+            p = line + 10;
+            forks = parseNumber(p, eol);
+        } else if (startsWith(line, eol, "procs_running ", 14)) {
+            p = line + 14;
+            out.procs_running = static_cast<unsigned long>(parseNumber(p, eol));
+        } else if (startsWith(line, eol, "procs_blocked ", 14)) {
+            p = line + 14;
+            out.procs_blocked = static_cast<unsigned long>(parseNumber(p, eol));
+        }
+        line = eol + 1;
+    }
+    if (!have_total) return false;
+
+    // Before the first sample the baseline is zero, i.e. boot.
+    out.since_boot = !hasPrevious;
+    out.interval_seconds = interval_seconds;
+    out.total = load(total, previousTotal);
+    out.jiffies = total.total() - std::min(total.total(), previousTotal.total());
+    out.context_switches = ctxt - std::min(ctxt, previousCtxt);
+    out.forks = forks - std::min(forks, previousForks);
+    if (previousCores.size() < currentCores.size()) previousCores.resize(currentCores.size(), CpuTimes());
+    out.cores.resize(currentCores.size());
+    for (size_t cpu = 0; cpu < currentCores.size(); ++cpu) {
+        if (!coreSeen[cpu]) currentCores[cpu] = previousCores[cpu]; // Offline: keep the baseline for when it returns
+        out.cores[cpu] = load(currentCores[cpu], previousCores[cpu]);
+        out.cores[cpu].online = coreSeen[cpu] != 0;
+    }
+
+    previousTotal = total;
+    previousCores.swap(currentCores);
+    previousCtxt = ctxt;
+    previousForks = forks;
+    hasPrevious = true;
+    return true;
+}
+
+bool CpuStatSampler::parseCpuLine(const char* p, const char* eol, CpuTimes& out) {
+    unsigned long long* fields[] = {&out.user,  &out.nice,    &out.system, &out.idle,  &out.iowait,
+                                    &out.irq,   &out.softirq, &out.steal,  &out.guest, &out.guest_nice};
+    for (unsigned long long* field : fields) *field = parseNumber(p, eol); // Missing trailing fields read as 0
+    return true;
+}
+
+// Shares of the jiffies that passed between two readings. The counters
+// are cumulative since boot and survive hotplug, but iowait in particular
+// can step backwards between reads, so each delta is clamped at zero.
+CpuLoad CpuStatSampler::load(const CpuTimes& now, const CpuTimes& before) {
+    auto delta = [](unsigned long long a, unsigned long long b) { return a > b ? a - b : 0ULL; };
+    unsigned long long user = delta(now.user, before.user) + delta(now.nice, before.nice);
+    unsigned long long system = delta(now.system, before.system);
+    unsigned long long idle = delta(now.idle, before.idle);
+    unsigned long long iowait = delta(now.iowait, before.iowait);
+    unsigned long long irq = delta(now.irq, before.irq) + delta(now.softirq, before.softirq);
+    unsigned long long steal = delta(now.steal, before.steal);
+    unsigned long long total = user + system + idle + iowait + irq + steal;
+    CpuLoad out = CpuLoad();
+    out.online = true;
+    if (total == 0) return out;
+    double scale = 100.0 / static_cast<double>(total);
+    out.user = user * scale;
+    out.system = system * scale;
+    out.iowait = iowait * scale;
+    out.irq = irq * scale;
+    out.steal = steal * scale;
+    out.busy = (user + system + irq) * scale;
+    return out;
+}
@@ -0,0 +1,77 @@
+#ifndef CPU_STAT_SAMPLER_H
+#define CPU_STAT_SAMPLER_H
+
+#include <vector>
+#include <cstddef>
+
+// Cumulative jiffies of one "cpu" line of /proc/stat, all ten fields.
+struct CpuTimes {
+    unsigned long long user;
+    unsigned long long nice;
+    unsigned long long system;
+    unsigned long long idle;
+    unsigned long long iowait;
+    unsigned long long irq;
+    unsigned long long softirq;
+    unsigned long long steal;
+    unsigned long long guest;      // Already included in user
+    unsigned long long guest_nice; // Already included in nice
+
+    unsigned long long total() const { return user + nice + system + idle + iowait + irq + softirq + steal; }
+    unsigned long long busy() const { return user + nice + system + irq + softirq; }
+};
+
+// Share of one interval, in percent of the CPU time available.
+struct CpuLoad {
+    double busy;    // user + system + irq: work done here (steal is not)
+    double user;    // user + nice
+    double system;
+    double iowait;
+    double irq;     // irq + softirq
+    double steal;
+    bool online;    // false for CPUs missing from /proc/stat this sample
+};
+
+struct CpuStatSnapshot {
+    CpuLoad total;
+    std::vector<CpuLoad> cores;         // Indexed by CPU number
+    unsigned long long context_switches; // During the interval
+    unsigned long long forks;
+    unsigned long procs_running;         // Instantaneous
+    unsigned long procs_blocked;
+    unsigned long long jiffies;          // Elapsed over all CPUs; 0 if no tick fell in the interval
+    double interval_seconds;
+    bool since_boot;                     // First sample: deltas are lifetime totals
+};
+
+// Keeps /proc/stat open and preads it whole each sample; loads are deltas
+// against the previous sample, not averages since boot.
+class CpuStatSampler {
+public:
+    CpuStatSampler();
+    ~CpuStatSampler();
+    CpuStatSampler(const CpuStatSampler&) = delete;
+    CpuStatSampler& operator=(const CpuStatSampler&) = delete;
+
+    bool sample(CpuStatSnapshot& out);
+    // Parses a /proc/stat image and computes deltas against the previous
+    // one; sample() is read + update.
+    bool update(const char* buf, size_t len, double interval_seconds, CpuStatSnapshot& out);
+
+private:
+    static bool parseCpuLine(const char* line, const char* eol, CpuTimes& out);
+    static CpuLoad load(const CpuTimes& now, const CpuTimes& before);
+
+    int stat_fd;
+    std::vector<char> buffer;     // Grows to fit; the intr line is long on big hosts
+    CpuTimes previousTotal;
+    std::vector<CpuTimes> previousCores;
+    std::vector<CpuTimes> currentCores;
+    std::vector<unsigned char> coreSeen;
+    unsigned long long previousCtxt;
+    unsigned long long previousForks;
+    bool hasPrevious;
+    double lastSampleTime;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "IdentityCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+const size_t IdentityCache::CMDLINE_LIMIT;
+
+std::shared_ptr<const ProcessIdentity> IdentityCache::load(int proc_fd, const ProcessKey& key, const char* comm) {
+    auto identity = std::make_shared<ProcessIdentity>();
+    std::string value;
+    identity->comm = pool.intern(comm);
+    readCmdline(proc_fd, key.pid, value);
+    identity->cmdline = pool.intern(value);
+    value.clear();
+    readExe(proc_fd, key.pid, value);
+    identity->exe = pool.intern(value);
+    value.clear();
+    readCgroupPath(proc_fd, key.pid, value);
+    identity->cgroup = pool.intern(value);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    identities[key] = identity;
+    return identity;
+}
+
+std::shared_ptr<const ProcessIdentity> IdentityCache::find(const ProcessKey& key) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = identities.find(key);
+    return (it == identities.end()) ? nullptr : it->second;
+}
+
+void IdentityCache::erase(const ProcessKey& key) {
+    std::lock_guard<std::mutex> lock(mtx);
+    identities.erase(key);
+}
+
+size_t IdentityCache::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return identities.size();
+}
+
+bool IdentityCache::readCmdline(int proc_fd, int pid, std::string& out) {
+    char path[24];
+    snprintf(path, sizeof(path), "%d/cmdline", pid);
+    int fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[CMDLINE_LIMIT];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return false; // Kernel threads and zombies have no cmdline
+    while (n > 0 && buf[n - 1] == '\0') --n;
+    for (ssize_t i = 0; i < n; ++i) {
+        if (buf[i] == '\0') buf[i] = ' ';
+    }
+    out.assign(buf, static_cast<size_t>(n));
+    return true;
+}
+
+bool IdentityCache::readExe(int proc_fd, int pid, std::string& out) {
+    char path[24];
+    snprintf(path, sizeof(path), "%d/exe", pid);
+    char target[4096];
+    ssize_t n = readlinkat(proc_fd, path, target, sizeof(target));
+    if (n <= 0 || n == static_cast<ssize_t>(sizeof(target))) return false;
+    out.assign(target, static_cast<size_t>(n));
+    return true;
+}
+
+// Picks the unified hierarchy ("0::/path") line of /proc/[pid]/cgroup.
+bool IdentityCache::readCgroupPath(int proc_fd, int pid, std::string& out) {
+    char path[24];
+    snprintf(path, sizeof(path), "%d/cgroup", pid);
+    int fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[1024];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+    for (char* line = buf; *line;) {
+        char* eol = strchr(line, '\n');
+        if (eol) *eol = '\0';
+        if (strncmp(line, "0::", 3) == 0) {
+            out.assign(line + 3);
+            return true;
+        }
+        if (!eol) break;
+        line = eol + 1;
+    }
+    return false;
+}
@@ -0,0 +1,44 @@
+#ifndef IDENTITY_CACHE_H
+#define IDENTITY_CACHE_H
+
+#include "ProcessKey.h"
+#include "StringPool.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// What a process is, as opposed to what it is doing: read once when the
+// process appears and again on exec, never on the scheduling path.
+struct ProcessIdentity {
+    InternedString comm;
+    InternedString cmdline; // argv joined with spaces, truncated at CMDLINE_LIMIT
+    InternedString exe;     // Empty for kernel threads or when not readable
+    InternedString cgroup;  // cgroup v2 path, e.g. "/user.slice/..."
+};
+
+// Identities keyed by (pid, starttime), with every string interned in one
+// pool. A rule interns the names it matches once; matching a process is then
+// a pointer comparison such as identity->comm == rule_comm.
+class IdentityCache {
+public:
+    static const size_t CMDLINE_LIMIT = 4096;
+
+    // Reads the identity relative to an open /proc fd and caches it,
+    // replacing any earlier identity for the same key (exec).
+    std::shared_ptr<const ProcessIdentity> load(int proc_fd, const ProcessKey& key, const char* comm);
+    std::shared_ptr<const ProcessIdentity> find(const ProcessKey& key) const;
+    void erase(const ProcessKey& key);
+    size_t size() const;
+    InternedString intern(const std::string& value) { return pool.intern(value); }
+
+    static bool readCmdline(int proc_fd, int pid, std::string& out);
+    static bool readExe(int proc_fd, int pid, std::string& out);
+    static bool readCgroupPath(int proc_fd, int pid, std::string& out);
+
+private:
+    StringPool pool;
+    mutable std::mutex mtx;
+    std::unordered_map<ProcessKey, std::shared_ptr<const ProcessIdentity>, ProcessKeyHash> identities;
+};
+
+#endif
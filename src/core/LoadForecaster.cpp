@@ -0,0 +1,62 @@
+#include "LoadForecaster.h"
+#include <algorithm>
+#include <cmath>
+
+const size_t LoadForecaster::WARMUP_SAMPLES;
+
+namespace {
+
+// Gaps longer than this are treated as a restart: the old trend says
+// nothing about what happens next.
+const double MAX_GAP_SECONDS = 30.0;
+
+}
+
+LoadForecaster::LoadForecaster(double alpha, double beta, double error_scale)
+    : alpha(alpha), beta(beta), errorScale(error_scale), floor(0.0), ceiling(100.0) {
+    reset();
+}
+
+void LoadForecaster::reset() {
+    smoothedLevel = 0.0;
+    smoothedTrend = 0.0;
+    lastTime = 0.0;
+    lastValue = 0.0;
+    observed = 0;
+    errors.clear();
+    naiveErrors.clear();
+}
+
+void LoadForecaster::update(double value, double now_seconds) {
+    double dt = now_seconds - lastTime;
+    if (observed > 0 && (dt <= 0.0 || dt > MAX_GAP_SECONDS)) {
+        if (dt > 0.0) reset(); // Stale: start over below
+        else return;           // Same instant or clock went back: ignore
+    }
+    if (observed == 0) {
+        smoothedLevel = value;
+        smoothedTrend = 0.0;
+    } else {
+        errors.push(std::fabs(forecast(dt) - value));
+        naiveErrors.push(std::fabs(lastValue - value));
+        double previous = smoothedLevel;
+        smoothedLevel = alpha * value + (1.0 - alpha) * (smoothedLevel + smoothedTrend * dt);
+        smoothedTrend = beta * (smoothedLevel - previous) / dt + (1.0 - beta) * smoothedTrend;
+    }
+    lastTime = now_seconds;
+    lastValue = value;
+    ++observed;
+}
+
+double LoadForecaster::forecast(double horizon_seconds) const {
+    double predicted = smoothedLevel + smoothedTrend * horizon_seconds;
+    return std::max(floor, std::min(ceiling, predicted));
+}
+
+double LoadForecaster::confidence() const {
+    if (errors.size() < WARMUP_SAMPLES || errorScale <= 0.0) return 0.0;
+    double error = errors.mean();
+    double accuracy = std::max(0.0, 1.0 - error / errorScale);
+    double skill = (error > naiveErrors.mean() && error > 0.0) ? naiveErrors.mean() / error : 1.0;
+    return accuracy * skill;
+}
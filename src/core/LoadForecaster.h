@@ -0,0 +1,63 @@
+#ifndef LOAD_FORECASTER_H
+#define LOAD_FORECASTER_H
+
+#include "RingBuffer.h"
+
+// What the scheduler expects a few quanta ahead, for policies that want to
+// act before load arrives rather than after.
+struct LoadOutlook {
+    double cpu;         // Busy %, forecast blended with the current load by confidence
+    double cpu_stall;   // % of time some task waited for a CPU (PSI)
+    double confidence;  // 0-1, of the CPU forecast
+};
+
+// Holt double exponential smoothing over irregularly spaced observations:
+// a smoothed level plus a trend in units per second, so a forecast is
+// level + trend * horizon. Scheduler cycles are not evenly spaced (PSI
+// wakeups cut sleeps short), hence the per-second trend.
+//
+// Every update scores the forecast the previous update made for this
+// moment, and the naive forecast (the previous value) alongside it.
+// confidence() maps the recent mean absolute error onto [0, 1] (1 when
+// exact, 0 once it reaches error_scale) and scales that down when the
+// trend has been doing worse than assuming load stays put. It is 0 while
+// fewer than WARMUP_SAMPLES errors have been scored.
+class LoadForecaster {
+public:
+    static const size_t WARMUP_SAMPLES = 5;
+
+    // alpha smooths the level, beta the trend; error_scale is the mean
+    // absolute error (in the series' units) that means "no confidence".
+    // The defaults had the lowest error 1-5 steps ahead on the traces of
+    // benchmarks/eval_load_forecaster.cpp.
+    LoadForecaster(double alpha = 0.3, double beta = 0.05, double error_scale = 20.0);
+
+    void update(double value, double now_seconds);
+    void reset();
+
+    // Predicted value horizon_seconds after the last update, clamped to
+    // [floor, ceiling] (0-100 by default: the series are percentages).
+    double forecast(double horizon_seconds) const;
+    double confidence() const;
+    double level() const { return smoothedLevel; }
+    double trend() const { return smoothedTrend; } // Units per second
+    double meanAbsoluteError() const { return errors.mean(); }
+    size_t samples() const { return observed; }
+    void setBounds(double low, double high) { floor = low; ceiling = high; }
+
+private:
+    double alpha;
+    double beta;
+    double errorScale;
+    double floor;
+    double ceiling;
+    double smoothedLevel;
+    double smoothedTrend;
+    double lastTime;
+    double lastValue;
+    size_t observed;
+    RingBuffer<double, 32> errors;      // |one-step forecast - actual| of recent updates
+    RingBuffer<double, 32> naiveErrors; // |previous value - actual|
+};
+
+#endif
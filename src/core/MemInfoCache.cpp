@@ -0,0 +1,150 @@
+#include "MemInfoCache.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct MemInfoField {
+    const char* name;
+    size_t len;
+    unsigned long long MemSnapshot::*field;
+};
+
+#define MEMINFO_FIELD(name, member) {name, sizeof(name) - 1, &MemSnapshot::member}
+
+// In /proc/meminfo order, so the scan below usually matches on the first try.
+const MemInfoField FIELDS[] = {
+    MEMINFO_FIELD("MemTotal", total),
+    MEMINFO_FIELD("MemFree", free),
+    MEMINFO_FIELD("MemAvailable", available),
+    MEMINFO_FIELD("Buffers", buffers),
+    MEMINFO_FIELD("Cached", cached),
+    MEMINFO_FIELD("SwapCached", swap_cached),
+    MEMINFO_FIELD("Active", active),
+    MEMINFO_FIELD("Inactive", inactive),
+    MEMINFO_FIELD("Active(anon)", active_anon),
+    MEMINFO_FIELD("Inactive(anon)", inactive_anon),
+    MEMINFO_FIELD("Active(file)", active_file),
+    MEMINFO_FIELD("Inactive(file)", inactive_file),
+    MEMINFO_FIELD("Unevictable", unevictable),
+    MEMINFO_FIELD("Mlocked", mlocked),
+    MEMINFO_FIELD("SwapTotal", swap_total),
+    MEMINFO_FIELD("SwapFree", swap_free),
+    MEMINFO_FIELD("Zswap", zswap),
+    MEMINFO_FIELD("Zswapped", zswapped),
+    MEMINFO_FIELD("Dirty", dirty),
+    MEMINFO_FIELD("Writeback", writeback),
+    MEMINFO_FIELD("AnonPages", anon_pages),
+    MEMINFO_FIELD("Mapped", mapped),
+    MEMINFO_FIELD("Shmem", shmem),
+    MEMINFO_FIELD("SReclaimable", slab_reclaimable),
+    MEMINFO_FIELD("SUnreclaim", slab_unreclaimable),
+    MEMINFO_FIELD("PageTables", page_tables),
+    MEMINFO_FIELD("CommitLimit", commit_limit),
+    MEMINFO_FIELD("Committed_AS", committed_as),
+};
+
+#undef MEMINFO_FIELD
+
+const size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+}
+
+const int MemInfoCache::DEFAULT_TTL_MS;
+
+MemInfoCache::MemInfoCache() : cached(), valid(false), ttl(DEFAULT_TTL_MS) {
+    meminfo_fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    if (meminfo_fd == -1) Logger::log("Failed to open /proc/meminfo");
+}
+
+MemInfoCache::~MemInfoCache() {
+    if (meminfo_fd != -1) close(meminfo_fd);
+}
+
+MemInfoCache& MemInfoCache::shared() {
+    static MemInfoCache cache;
+    return cache;
+}
+
+bool MemInfoCache::get(MemSnapshot& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!valid || std::chrono::steady_clock::now() - cached.taken >= ttl) {
+        if (!read()) return false;
+    }
+    out = cached;
+    return true;
+}
+
+bool MemInfoCache::refresh() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return read();
+}
+
+bool MemInfoCache::refresh(MemSnapshot& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!read()) return false;
+    out = cached;
+    return true;
+}
+
+void MemInfoCache::setTtl(std::chrono::milliseconds value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    ttl = value;
+}
+
+// On failure the cache is left invalid, so the next get() tries again.
+bool MemInfoCache::read() {
+    valid = false;
+    if (meminfo_fd == -1) return false;
+    size_t len = 0;
+    while (len < sizeof(buffer)) {
+        ssize_t n = pread(meminfo_fd, buffer + len, sizeof(buffer) - len, static_cast<off_t>(len));
+        if (n < 0) return false;
+        if (n == 0) break;
+        len += static_cast<size_t>(n);
+    }
+    if (!parse(buffer, len, cached)) return false;
+    cached.taken = std::chrono::steady_clock::now();
+    valid = true;
+    return true;
+}
+
+// Lines look like "MemAvailable:   12345678 kB".
+bool MemInfoCache::parse(const char* buf, size_t len, MemSnapshot& out) {
+    out = MemSnapshot();
+    const char* end = buf + len;
+    size_t next = 0;
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        const char* colon = static_cast<const char*>(memchr(line, ':', eol - line));
+        if (colon) {
+            size_t key_len = static_cast<size_t>(colon - line);
+            for (size_t tried = 0; tried < FIELD_COUNT; ++tried) {
+                const MemInfoField& field = FIELDS[(next + tried) % FIELD_COUNT];
+                if (field.len != key_len || memcmp(field.name, line, key_len) != 0) continue;
+                const char* p = colon + 1;
+                while (p < eol && *p == ' ') ++p;
+                unsigned long long value = 0;
+                for (; p < eol && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+                out.*field.field = value;
+                if (field.field == &MemSnapshot::available) out.has_available = true;
+                next = (next + tried + 1) % FIELD_COUNT;
+                break;
+            }
+        }
+        line = eol + 1;
+    }
+    if (out.total == 0) return false;
+    if (!out.has_available) {
+        // Pre-3.14 kernels: free memory plus the file cache that can be dropped.
+        unsigned long long reclaimable = out.buffers + out.cached + out.slab_reclaimable;
+        reclaimable -= std::min(reclaimable, out.shmem);
+        out.available = out.free + reclaimable;
+    }
+    if (out.available > out.total) out.available = out.total;
+    return true;
+}
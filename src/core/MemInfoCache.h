@@ -0,0 +1,80 @@
+#ifndef MEM_INFO_CACHE_H
+#define MEM_INFO_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+// Fields of /proc/meminfo, in KB. Fields the kernel does not report stay 0.
+struct MemSnapshot {
+    unsigned long long total;
+    unsigned long long free;
+    unsigned long long available;     // Estimated from free + file cache before Linux 3.14
+    unsigned long long buffers;
+    unsigned long long cached;        // Page cache, excluding swap cache
+    unsigned long long swap_cached;
+    unsigned long long active;
+    unsigned long long inactive;
+    unsigned long long active_anon;
+    unsigned long long inactive_anon;
+    unsigned long long active_file;
+    unsigned long long inactive_file;
+    unsigned long long unevictable;
+    unsigned long long mlocked;
+    unsigned long long swap_total;
+    unsigned long long swap_free;
+    unsigned long long zswap;         // Compressed pool size
+    unsigned long long zswapped;      // Uncompressed size of what it holds
+    unsigned long long dirty;
+    unsigned long long writeback;
+    unsigned long long anon_pages;
+    unsigned long long mapped;
+    unsigned long long shmem;         // Counted in cached but not reclaimable by dropping
+    unsigned long long slab_reclaimable;
+    unsigned long long slab_unreclaimable;
+    unsigned long long page_tables;
+    unsigned long long commit_limit;
+    unsigned long long committed_as;
+    bool has_available;               // MemAvailable came from the kernel
+    std::chrono::steady_clock::time_point taken;
+
+    // Share of RAM that cannot be handed out without reclaiming or swapping.
+    double usedPercent() const { return total ? 100.0 * (total - available) / total : 0.0; }
+    double swapUsedPercent() const { return swap_total ? 100.0 * (swap_total - swap_free) / swap_total : 0.0; }
+};
+
+// Keeps /proc/meminfo open and serves one parsed snapshot to every caller.
+// get() re-reads only when the snapshot is older than the TTL; the
+// scheduling cycle calls refresh() once at its start, so everything in the
+// cycle sees the same numbers without touching procfs again.
+class MemInfoCache {
+public:
+    static const int DEFAULT_TTL_MS = 100;
+
+    MemInfoCache();
+    ~MemInfoCache();
+    MemInfoCache(const MemInfoCache&) = delete;
+    MemInfoCache& operator=(const MemInfoCache&) = delete;
+
+    // Process-wide instance; /proc/meminfo is global, so one cache is enough.
+    static MemInfoCache& shared();
+
+    bool get(MemSnapshot& out);
+    bool refresh();
+    bool refresh(MemSnapshot& out);
+    void setTtl(std::chrono::milliseconds value);
+    // Parses a /proc/meminfo image without allocating.
+    static bool parse(const char* buf, size_t len, MemSnapshot& out);
+
+private:
+    bool read();
+
+    std::mutex mtx;
+    int meminfo_fd;
+    char buffer[8192];  // /proc/meminfo is under 2KB
+    MemSnapshot cached;
+    bool valid;
+    std::chrono::milliseconds ttl;
+};
+
+#endif
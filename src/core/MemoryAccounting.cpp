@@ -0,0 +1,195 @@
+#include "MemoryAccounting.h"
+#include "Logger.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct RollupField {
+    const char* name;
+    size_t len;
+    unsigned long long MemoryFootprint::*field;
+};
+
+#define ROLLUP_FIELD(name, member) {name, sizeof(name) - 1, &MemoryFootprint::member}
+
+// In smaps_rollup order.
+const RollupField FIELDS[] = {
+    ROLLUP_FIELD("Rss", rss),
+    ROLLUP_FIELD("Pss", pss),
+    ROLLUP_FIELD("Pss_Anon", pss_anon),
+    ROLLUP_FIELD("Pss_File", pss_file),
+    ROLLUP_FIELD("Pss_Shmem", pss_shmem),
+    ROLLUP_FIELD("Shared_Clean", shared_clean),
+    ROLLUP_FIELD("Shared_Dirty", shared_dirty),
+    ROLLUP_FIELD("Private_Clean", private_clean),
+    ROLLUP_FIELD("Private_Dirty", private_dirty),
+    ROLLUP_FIELD("Anonymous", anonymous),
+    ROLLUP_FIELD("Swap", swap),
+    ROLLUP_FIELD("SwapPss", swap_pss),
+    ROLLUP_FIELD("Locked", locked),
+};
+
+#undef ROLLUP_FIELD
+
+const size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+const unsigned long long PAGE_KB = static_cast<unsigned long long>(sysconf(_SC_PAGESIZE)) / 1024;
+
+}
+
+MemoryAccounting::MemoryAccounting(const std::string& proc_root, const std::string& page_idle_path)
+    : procRoot(proc_root), estimator(page_idle_path, proc_root), newCursor(0), rollupCursor(0), windowCursor(0), generation(0) {}
+
+// Lines after the "[rollup]" header are "Name:   value kB".
+bool MemoryAccounting::parseSmapsRollup(const char* buf, size_t len, MemoryFootprint& out) {
+    out = MemoryFootprint();
+    const char* end = buf + len;
+    const char* line = static_cast<const char*>(memchr(buf, '\n', len));
+    if (!line) return false;
+    size_t next = 0;
+    bool found = false;
+    for (++line; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        const char* colon = static_cast<const char*>(memchr(line, ':', eol - line));
+        if (colon) {
+            size_t name_len = static_cast<size_t>(colon - line);
+            for (size_t tried = 0; tried < FIELD_COUNT; ++tried) {
+                const RollupField& field = FIELDS[(next + tried) % FIELD_COUNT];
+                if (field.len != name_len || memcmp(field.name, line, name_len) != 0) continue;
+                const char* p = colon + 1;
+                while (p < eol && *p == ' ') ++p;
+                unsigned long long value = 0;
+                for (; p < eol && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+                out.*field.field = value;
+                next = (next + tried + 1) % FIELD_COUNT;
+                found = true;
+                break;
+            }
+        }
+        line = eol + 1;
+    }
+    return found;
+}
+
+bool MemoryAccounting::readRollup(int pid, MemoryFootprint& out) {
+    std::string path = procRoot + "/" + std::to_string(pid) + "/smaps_rollup";
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return false;
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    return n > 0 && parseSmapsRollup(buffer, static_cast<size_t>(n), out);
+}
+
+// Processes seen for the first time are read before any refresh, so a new
+// process is accounted within a cycle or two even on a busy host. The
+// budget counts attempts, or processes whose rollup cannot be read (other
+// users', or exited) would be retried without limit every cycle; the
+// first pass starts where the last one stopped so they cannot starve the
+// rest either.
+void MemoryAccounting::update(const SchedulerConfig& config, const ProcessSnapshot& snapshot) {
+    ++generation;
+    auto now = std::chrono::steady_clock::now();
+    size_t budget = static_cast<size_t>(config.memory_rollups_per_cycle);
+    size_t read = 0;
+    const auto& pids = snapshot.pids();
+    size_t start = newCursor;
+    for (size_t visited = 0; visited < snapshot.size(); ++visited) {
+        size_t i = (start + visited) % snapshot.size();
+        if (snapshot.classes()[i] == ProcessClass::KERNEL) continue; // No user address space
+        ProcessKey key = {pids[i], snapshot.startTimes()[i]};
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            it->second.generation = generation;
+            continue;
+        }
+        if (read == budget) continue;
+        ++read;
+        newCursor = i + 1;
+        ProcessMemory memory = ProcessMemory();
+        if (!readRollup(pids[i], memory.footprint)) continue;
+        memory.measured = now;
+        memory.generation = generation;
+        cache.emplace(key, memory);
+    }
+    start = rollupCursor;
+    for (size_t visited = 0; visited < snapshot.size() && read < budget; ++visited) {
+        size_t i = (start + visited) % snapshot.size();
+        auto it = cache.find(ProcessKey{pids[i], snapshot.startTimes()[i]});
+        if (it == cache.end() || it->second.measured == now) continue;
+        if (readRollup(pids[i], it->second.footprint)) it->second.measured = now;
+        ++read;
+        rollupCursor = i + 1;
+    }
+    for (auto it = cache.begin(); it != cache.end();) {
+        it = (it->second.generation == generation) ? std::next(it) : cache.erase(it);
+    }
+    for (auto it = windows.begin(); it != windows.end();) {
+        it = cache.count(it->first) ? std::next(it) : windows.erase(it);
+    }
+    sampleWorkingSets(config, snapshot);
+
+    unsigned long long pss = 0, swap = 0, working_set = 0;
+    size_t with_working_set = 0;
+    for (const auto& entry : cache) {
+        pss += entry.second.footprint.pss;
+        swap += entry.second.footprint.swap;
+        if (entry.second.has_working_set) {
+            working_set += entry.second.working_set_kb;
+            ++with_working_set;
+        }
+    }
+    Logger::log("Memory accounting: " + std::to_string(cache.size()) + " processes (" + std::to_string(read) +
+                " read this cycle), PSS " + std::to_string(pss / 1024) + " MB, swap " + std::to_string(swap / 1024) +
+                " MB, working set " + std::to_string(working_set / 1024) + " MB over " +
+                std::to_string(with_working_set) + " processes");
+}
+
+void MemoryAccounting::sampleWorkingSets(const SchedulerConfig& config, const ProcessSnapshot& snapshot) {
+    if (config.working_set_window_ms <= 0 || !estimator.isSupported()) {
+        windows.clear();
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::milliseconds window_length(config.working_set_window_ms);
+    for (auto it = windows.begin(); it != windows.end();) {
+        if (now - it->second.began < window_length) {
+            ++it;
+            continue;
+        }
+        WorkingSetEstimate estimate;
+        auto cached = cache.find(it->first);
+        if (cached != cache.end() && estimator.finish(it->second, estimate)) {
+            cached->second.working_set_kb = estimate.working_set_kb;
+            cached->second.working_set_measured = now;
+            cached->second.has_working_set = true;
+        }
+        it = windows.erase(it);
+    }
+
+    size_t opened = 0;
+    const auto& pids = snapshot.pids();
+    size_t start = windowCursor;
+    for (size_t visited = 0; visited < snapshot.size(); ++visited) {
+        if (opened == static_cast<size_t>(config.working_set_processes_per_cycle)) break;
+        size_t i = (start + visited) % snapshot.size();
+        ProcessKey key = {pids[i], snapshot.startTimes()[i]};
+        auto cached = cache.find(key);
+        if (cached == cache.end() || windows.count(key)) continue;
+        WorkingSetWindow window;
+        if (estimator.begin(pids[i], cached->second.footprint.rss / PAGE_KB, window)) {
+            windows.emplace(key, std::move(window));
+        }
+        ++opened;
+        windowCursor = i + 1;
+    }
+}
+
+bool MemoryAccounting::find(const ProcessKey& key, ProcessMemory& out) const {
+    auto it = cache.find(key);
+    if (it == cache.end()) return false;
+    out = it->second;
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include "types.h"
+#include "ProcessKey.h"
+#include "ProcessSnapshot.h"
+#include "WorkingSetEstimator.h"
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+
+// Totals of /proc/[pid]/smaps_rollup, in KB. Fields the kernel does not
+// report stay 0 (Pss_Anon/File/Shmem need Linux 5.9).
+struct MemoryFootprint {
+    unsigned long long rss;
+    unsigned long long pss;          // Shared pages divided among their mappers
+    unsigned long long pss_anon;
+    unsigned long long pss_file;
+    unsigned long long pss_shmem;
+    unsigned long long shared_clean;
+    unsigned long long shared_dirty;
+    unsigned long long private_clean;
+    unsigned long long private_dirty;
+    unsigned long long anonymous;
+    unsigned long long swap;
+    unsigned long long swap_pss;
+    unsigned long long locked;
+};
+
+struct ProcessMemory {
+    MemoryFootprint footprint;
+    std::chrono::steady_clock::time_point measured;
+    unsigned long long working_set_kb; // Valid when has_working_set
+    std::chrono::steady_clock::time_point working_set_measured;
+    bool has_working_set;
+    unsigned long long generation;     // Last cycle the process was in the snapshot
+};
+
+// Per-process memory accounting that costs a bounded amount per cycle.
+// smaps_rollup walks the whole page table of a process, so each cycle reads
+// it for at most memory_rollups_per_cycle processes, round-robin, and keeps
+// the last figures for the rest. Working-set windows (see
+// WorkingSetEstimator) are opened for working_set_processes_per_cycle
+// processes per cycle and closed once working_set_window_ms has passed.
+class MemoryAccounting {
+public:
+    explicit MemoryAccounting(const std::string& proc_root = "/proc",
+                              const std::string& page_idle_path = "/sys/kernel/mm/page_idle/bitmap");
+    MemoryAccounting(const MemoryAccounting&) = delete;
+    MemoryAccounting& operator=(const MemoryAccounting&) = delete;
+
+    void update(const SchedulerConfig& config, const ProcessSnapshot& snapshot);
+    bool find(const ProcessKey& key, ProcessMemory& out) const;
+    size_t size() const { return cache.size(); }
+    bool workingSetSupported() const { return estimator.isSupported(); }
+
+    bool readRollup(int pid, MemoryFootprint& out);
+    // Parses a smaps_rollup image without allocating.
+    static bool parseSmapsRollup(const char* buf, size_t len, MemoryFootprint& out);
+
+private:
+    void sampleWorkingSets(const SchedulerConfig& config, const ProcessSnapshot& snapshot);
+
+    std::string procRoot;
+    WorkingSetEstimator estimator;
+    std::unordered_map<ProcessKey, ProcessMemory, ProcessKeyHash> cache;
+    std::unordered_map<ProcessKey, WorkingSetWindow, ProcessKeyHash> windows;
+    size_t newCursor;      // Snapshot row where the next cycle's first reads start
+    size_t rollupCursor;   // Same, for refreshes of processes already read
+    size_t windowCursor;
+    unsigned long long generation;
+    char buffer[4096];     // smaps_rollup is about 1KB
+};
+
+#endif
@@ -1,53 +1,94 @@
 #include "MemoryManager.h"
 #include "Logger.h"
-#include <fstream>
-#include <sstream>
-#include <numeric>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+const double COLD_CPU_PERCENT = 1.0; // Background processes below this are reclaim candidates
+
+}
 
 double MemoryManager::getSystemMemoryUsage() {
-    std::ifstream meminfo("/proc/meminfo");
-    std::string line;
-    long total = 0, free = 0;
-    while (std::getline(meminfo, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        long value;
-        iss >> key >> value;
-        if (key == "MemTotal:") total = value;
-        if (key == "MemFree:") free = value;
-    }
-    meminfo.close();
-    return (total > 0) ? 100.0 * (total - free) / total : 0.0;
+    MemSnapshot memory;
+    return MemInfoCache::shared().get(memory) ? memory.usedPercent() : 0.0;
 }
 
-void MemoryManager::monitorMemory(const SchedulerConfig& config) {
-    double usage = getSystemMemoryUsage();
+// Proactive cgroup reclaim runs every cycle to keep headroom; the
+// per-process page-out below is the last resort once usage is high anyway.
+void MemoryManager::monitorMemory(const SchedulerConfig& config, const ProcessSnapshot& snapshot) {
+    MemSnapshot memory;
+    bool have_memory = MemInfoCache::shared().get(memory);
+    double usage = have_memory ? memory.usedPercent() : 0.0;
     Logger::log("System Memory Usage: " + std::to_string(usage) + "%");
-    if (usage > config.memory_threshold_mb / 100.0) {
-        Logger::log("Memory threshold exceeded, optimizing...");
-        auto processes = ProcessManager().getRunningProcesses();
-        for (const auto& proc : processes) {
-            optimizeMemory(proc.pid, proc.memory_usage);
-        }
+    memoryAccounting.update(config, snapshot);
+    if (have_memory && memory.total > 0) {
+        cgroupReclaimer.update(config, snapshot, 100.0 * memory.available / memory.total);
+    }
+    if (config.reclaim_advice != "off" && usage > config.reclaim_trigger_percent) {
+        Logger::log("Memory usage above " + std::to_string(config.reclaim_trigger_percent) +
+                    "%, reclaiming from cold background processes...");
+        reclaimColdBackground(config, snapshot);
     }
 }
 
-void MemoryManager::optimizeMemory(int pid, long memory_usage) {
-    simulateZswapCompression(pid, memory_usage);
-    manageSwap(pid, memory_usage);
-    predictMemoryNeeds(pid);
-}
+// Only BACKGROUND processes that are nearly idle are touched, the most
+// cold memory first, until the cycle's budget is spent; foreground,
+// session and system processes keep their memory.
+void MemoryManager::reclaimColdBackground(const SchedulerConfig& config, const ProcessSnapshot& snapshot) {
+    if (!PageReclaimer::isSupported()) {
+        Logger::log("process_madvise unavailable, no reclaim");
+        return;
+    }
+    std::vector<size_t> candidates;
+    snapshot.actionable().forEachSet([&](size_t i) {
+        if (snapshot.classes()[i] == ProcessClass::BACKGROUND && snapshot.cpuUsage()[i] < COLD_CPU_PERCENT &&
+            snapshot.memoryUsage()[i] > 0) {
+            candidates.push_back(i);
+        }
+    });
+    std::vector<unsigned long long> cold(snapshot.size(), 0);
+    for (size_t i : candidates) cold[i] = coldMemory(snapshot, i);
+    std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) { return cold[a] > cold[b]; });
 
-void MemoryManager::simulateZswapCompression(int pid, long memory_usage) {
-    double compression_ratio = 0.5; // Simulated compression
-    Logger::log("Simulating zswap compression for PID " + std::to_string(pid) + ": " + std::to_string(memory_usage * compression_ratio) + " KB");
+    static const long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    size_t budget = static_cast<size_t>(config.reclaim_budget_mb) * 1024 / page_kb;
+    ReclaimAdvice advice = (config.reclaim_advice == "pageout") ? ReclaimAdvice::PAGEOUT : ReclaimAdvice::COLD;
+    for (size_t i : candidates) {
+        if (budget == 0) break;
+        int pid = snapshot.pids()[i];
+        ReclaimResult result;
+        if (!reclaimer.reclaim(pid, snapshot.startTimes()[i], advice, budget, result)) {
+            Logger::log("Could not reclaim from PID " + std::to_string(pid) + ": " + strerror(errno));
+            continue;
+        }
+        budget -= std::min(budget, result.advised_pages);
+        Logger::log("Reclaimed " + std::to_string(result.reclaimed_pages) + " pages from PID " + std::to_string(pid) +
+                    " (" + config.reclaim_advice + " advised " + std::to_string(result.advised_pages) + " pages in " +
+                    std::to_string(result.ranges) + " ranges)");
+        predictMemoryNeeds(pid);
+    }
 }
 
-void MemoryManager::manageSwap(int pid, long memory_usage) {
-    Logger::log("Managing swap for PID " + std::to_string(pid) + ": " + std::to_string(memory_usage) + " KB");
+// Anonymous memory outside the measured working set when there is one;
+// otherwise all anonymous memory, or the resident size before the first
+// smaps_rollup read.
+unsigned long long MemoryManager::coldMemory(const ProcessSnapshot& snapshot, size_t row) const {
+    ProcessMemory memory;
+    if (!memoryAccounting.find(ProcessKey{snapshot.pids()[row], snapshot.startTimes()[row]}, memory)) {
+        return static_cast<unsigned long long>(snapshot.memoryUsage()[row]);
+    }
+    unsigned long long anonymous = memory.footprint.anonymous;
+    if (!memory.has_working_set) return anonymous;
+    return anonymous - std::min(anonymous, memory.working_set_kb);
 }
 
 void MemoryManager::predictMemoryNeeds(int pid) {
-    memoryTrend[pid] = memoryTrend[pid] * 0.8 + getSystemMemoryUsage() * 0.2; // Exponential moving average
-    Logger::log("Predicted memory need for PID " + std::to_string(pid) + ": " + std::to_string(memoryTrend[pid]) + "%");
-}
\ No newline at end of file
+    RingBuffer<double, 8>& trend = memoryTrend[pid];
+    trend.push(getSystemMemoryUsage());
+    Logger::log("Predicted memory need for PID " + std::to_string(pid) + ": " + std::to_string(trend.ewma()) + "% (peak " +
+                std::to_string(trend.max()) + "%)");
+}
@@ -2,19 +2,28 @@
 #define MEMORY_MANAGER_H
 
 #include "types.h"
-#include <map>
+#include "ProcessSnapshot.h"
+#include "MemInfoCache.h"
+#include "PageReclaimer.h"
+#include "CgroupReclaimer.h"
+#include "MemoryAccounting.h"
+#include "RingBuffer.h"
+#include <unordered_map>
 
 class MemoryManager {
 public:
-    void monitorMemory(const SchedulerConfig& config);
-    void optimizeMemory(int pid, long memory_usage);
-    double getSystemMemoryUsage();
+    void monitorMemory(const SchedulerConfig& config, const ProcessSnapshot& snapshot);
+    double getSystemMemoryUsage(); // From the shared meminfo cache
     void predictMemoryNeeds(int pid);
+    const MemoryAccounting& accounting() const { return memoryAccounting; }
 
 private:
-    void simulateZswapCompression(int pid, long memory_usage);
-    void manageSwap(int pid, long memory_usage);
-    std::map<int, double> memoryTrend; // For predictive allocation
+    void reclaimColdBackground(const SchedulerConfig& config, const ProcessSnapshot& snapshot);
+    unsigned long long coldMemory(const ProcessSnapshot& snapshot, size_t row) const;
+    MemoryAccounting memoryAccounting;
+    PageReclaimer reclaimer;
+    CgroupReclaimer cgroupReclaimer;
+    std::unordered_map<int, RingBuffer<double, 8>> memoryTrend; // For predictive allocation
 };
 
-#endif
\ No newline at end of file
+#endif
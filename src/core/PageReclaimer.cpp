@@ -0,0 +1,136 @@
+#include "PageReclaimer.h"
+#include "ProcScanner.h"
+#include "FileUtils.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_process_madvise
+#define SYS_process_madvise 440
+#endif
+#ifndef MADV_COLD
+#define MADV_COLD 20
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
+namespace {
+
+const size_t MAX_IOVECS = 1024; // UIO_MAXIOV; longer lists take several calls
+
+const long PAGE_SIZE_BYTES = sysconf(_SC_PAGESIZE);
+
+// Resident KB from /proc/[pid]/statm, or -1 if it cannot be read.
+long residentKb(int pid, std::vector<char>& buffer) {
+    size_t len = 0;
+    if (!FileUtils::readAll("/proc/" + std::to_string(pid) + "/statm", buffer, len) || len == 0) return -1;
+    return ProcScanner::parseStatm(buffer.data(), len);
+}
+
+}
+
+bool PageReclaimer::isSupported() {
+    static const bool supported = [] {
+        // An invalid pidfd fails with EBADF where the syscall exists.
+        return syscall(SYS_process_madvise, -1, nullptr, 0, MADV_COLD, 0) == -1 && errno != ENOSYS;
+    }();
+    return supported;
+}
+
+// Lines are "start-end perms offset dev inode [path]".
+void PageReclaimer::parseAnonRanges(const char* buf, size_t len, std::vector<struct iovec>& out) {
+    out.clear();
+    const char* end = buf + len;
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        char* p = nullptr;
+        unsigned long start = strtoul(line, &p, 16);
+        unsigned long stop = (p < eol && *p == '-') ? strtoul(p + 1, &p, 16) : 0;
+        while (p < eol && *p == ' ') ++p;
+        bool writable_private = eol - p >= 4 && p[1] == 'w' && p[3] == 'p';
+        int field = 0;
+        for (; p < eol && field < 4; ++field) { // perms, offset, dev, inode
+            while (p < eol && *p != ' ') ++p;
+            while (p < eol && *p == ' ') ++p;
+        }
+        size_t path_len = static_cast<size_t>(eol - p);
+        bool anonymous = path_len == 0 || (path_len == 6 && memcmp(p, "[heap]", 6) == 0) ||
+                         (path_len > 6 && memcmp(p, "[anon:", 6) == 0);
+        if (field == 4 && writable_private && anonymous && stop > start) {
+            struct iovec range;
+            range.iov_base = reinterpret_cast<void*>(start);
+            range.iov_len = stop - start;
+            out.push_back(range);
+        }
+        line = eol + 1;
+    }
+}
+
+// The pidfd pins the process we checked, so the maps read through its PID
+// and the advice given through the fd describe the same address space.
+bool PageReclaimer::reclaim(int pid, unsigned long long starttime, ReclaimAdvice advice, size_t max_pages,
+                            ReclaimResult& out) {
+    out = ReclaimResult();
+    int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd == -1) return false;
+    ProcStat stat;
+    if (starttime != 0 && (!ProcStatParser::read(pid, stat) || stat.starttime != starttime)) {
+        close(pidfd);
+        errno = ESRCH;
+        return false;
+    }
+    size_t len = 0;
+    if (!FileUtils::readAll("/proc/" + std::to_string(pid) + "/maps", mapsBuffer, len)) {
+        int saved_errno = errno;
+        close(pidfd);
+        errno = saved_errno;
+        return false;
+    }
+    parseAnonRanges(mapsBuffer.data(), len, ranges);
+
+    // Trim the list to the budget, cutting the last range short.
+    size_t budget = max_pages * static_cast<size_t>(PAGE_SIZE_BYTES);
+    size_t count = 0;
+    for (; count < ranges.size() && budget > 0; ++count) {
+        ranges[count].iov_len = std::min(ranges[count].iov_len, budget);
+        budget -= ranges[count].iov_len;
+    }
+
+    long resident_before = residentKb(pid, mapsBuffer); // Ranges are parsed; the buffer is free
+    int madvise_advice = (advice == ReclaimAdvice::PAGEOUT) ? MADV_PAGEOUT : MADV_COLD;
+    size_t advised_bytes = 0;
+    int error = 0;
+    for (size_t first = 0; first < count; first += MAX_IOVECS) {
+        size_t batch = std::min(MAX_IOVECS, count - first);
+        ssize_t n = syscall(SYS_process_madvise, pidfd, ranges.data() + first, batch, madvise_advice, 0);
+        if (n < 0) {
+            error = errno;
+            break;
+        }
+        advised_bytes += static_cast<size_t>(n);
+    }
+    long resident_after = residentKb(pid, mapsBuffer);
+    close(pidfd);
+
+    out.advised_pages = advised_bytes / static_cast<size_t>(PAGE_SIZE_BYTES);
+    out.ranges = count;
+    if (resident_before >= 0 && resident_after >= 0) {
+        out.reclaimed_pages = (resident_before - resident_after) / (PAGE_SIZE_BYTES / 1024);
+    }
+    if (advised_bytes == 0 && error != 0) {
+        errno = error;
+        return false;
+    }
+    return true;
+}
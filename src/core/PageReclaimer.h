@@ -0,0 +1,38 @@
+#ifndef PAGE_RECLAIMER_H
+#define PAGE_RECLAIMER_H
+
+#include <vector>
+#include <cstddef>
+#include <sys/uio.h>
+
+enum class ReclaimAdvice { COLD, PAGEOUT };
+
+struct ReclaimResult {
+    size_t advised_pages;  // Pages the kernel accepted the advice for
+    long reclaimed_pages;  // Drop in resident pages across the call; ~0 for COLD
+    size_t ranges;         // Anonymous ranges advised
+};
+
+// Pushes another process's private anonymous memory toward reclaim with
+// process_madvise(2) through a pidfd: MADV_COLD only deactivates the pages,
+// MADV_PAGEOUT reclaims them (to swap or zswap) before returning. File
+// mappings are left to the page cache, and the stack is skipped as it is
+// always hot. Needs Linux 5.10 and CAP_SYS_NICE over the target.
+class PageReclaimer {
+public:
+    static bool isSupported();
+
+    // Advises at most max_pages. starttime (0 = unchecked) guards against a
+    // recycled PID. False with errno set if nothing could be advised.
+    bool reclaim(int pid, unsigned long long starttime, ReclaimAdvice advice, size_t max_pages, ReclaimResult& out);
+
+    // Private writable anonymous VMAs of a /proc/[pid]/maps image, including
+    // [heap] and named [anon:...] regions.
+    static void parseAnonRanges(const char* buf, size_t len, std::vector<struct iovec>& out);
+
+private:
+    std::vector<char> mapsBuffer;
+    std::vector<struct iovec> ranges;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "PidfdWatcher.h"
+#include "ProcStatParser.h"
+#include "Logger.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+namespace {
+
+int pidfdOpen(int pid) {
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+}
+
+int pidfdSendSignal(int fd, int sig) {
+    return static_cast<int>(syscall(SYS_pidfd_send_signal, fd, sig, nullptr, 0));
+}
+
+const size_t RESERVED_FDS = 256; // Left for sockets, cgroup files and /proc reads
+
+}
+
+PidfdWatcher::PidfdWatcher() : epoll_fd(-1), wake_fd(-1), running(false), nextSerial(0), budget(0) {}
+
+PidfdWatcher::~PidfdWatcher() {
+    stop();
+}
+
+bool PidfdWatcher::isSupported() {
+    static const bool supported = [] {
+        int fd = pidfdOpen(getpid());
+        if (fd == -1) return false;
+        close(fd);
+        return true;
+    }();
+    return supported;
+}
+
+bool PidfdWatcher::start(std::function<void(int pid, unsigned long long starttime)> handler) {
+    if (running) return true;
+    if (!isSupported()) {
+        Logger::log("pidfd unavailable, exits are detected by /proc scans");
+        return false;
+    }
+    // One fd per watched process; lift the soft limit as far as allowed.
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        if (limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+            getrlimit(RLIMIT_NOFILE, &limit);
+        }
+        budget = (limit.rlim_cur > RESERVED_FDS * 2) ? static_cast<size_t>(limit.rlim_cur) - RESERVED_FDS
+                                                     : static_cast<size_t>(limit.rlim_cur) / 2;
+    }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (epoll_fd == -1 || wake_fd == -1) {
+        Logger::log("pidfd watcher setup failed: " + std::string(strerror(errno)));
+        if (epoll_fd != -1) close(epoll_fd);
+        if (wake_fd != -1) close(wake_fd);
+        epoll_fd = wake_fd = -1;
+        return false;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = UINT64_MAX; // Wakeup marker
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+    this->handler = std::move(handler);
+    running = true;
+    waiter = std::thread(&PidfdWatcher::run, this);
+    Logger::log("pidfd exit watcher started, budget " + std::to_string(budget) + " processes");
+    return true;
+}
+
+void PidfdWatcher::stop() {
+    if (!running) return;
+    running = false;
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) {
+        Logger::log("Failed to wake pidfd watcher");
+    }
+    if (waiter.joinable()) waiter.join();
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& entry : watches) close(entry.second.fd);
+    watches.clear();
+    close(epoll_fd);
+    close(wake_fd);
+    epoll_fd = wake_fd = -1;
+}
+
+bool PidfdWatcher::watch(int pid, unsigned long long starttime) {
+    if (!running) return false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = watches.find(pid);
+        if (it != watches.end() && it->second.starttime == starttime) return true;
+        if (watches.size() >= budget) return false;
+    }
+    int fd = pidfdOpen(pid);
+    if (fd == -1) return false;
+    // The PID may have been recycled since the caller read it.
+    ProcStat stat;
+    if (!ProcStatParser::read(pid, stat) || stat.starttime != starttime) {
+        close(fd);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = watches.find(pid);
+    if (it != watches.end()) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        watches.erase(it);
+    }
+    uint32_t serial = ++nextSerial;
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = (static_cast<uint64_t>(serial) << 32) | static_cast<uint32_t>(pid);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        close(fd);
+        return false;
+    }
+    watches[pid] = Watch{fd, starttime, serial};
+    return true;
+}
+
+void PidfdWatcher::unwatch(int pid) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = watches.find(pid);
+    if (it == watches.end()) return;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    watches.erase(it);
+}
+
+bool PidfdWatcher::isWatched(int pid) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return watches.count(pid) != 0;
+}
+
+size_t PidfdWatcher::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return watches.size();
+}
+
+// A temporary pidfd is checked against starttime after it is opened, as in
+// watch(): once the fd is held the PID cannot be handed to anyone else, so
+// a match means the signal reaches the process the caller meant.
+bool PidfdWatcher::sendSignal(const ProcessKey& key, int sig) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = watches.find(key.pid);
+        if (it != watches.end() && it->second.starttime == key.starttime) {
+            return pidfdSendSignal(it->second.fd, sig) == 0;
+        }
+    }
+    ProcStat stat;
+    if (!isSupported()) {
+        // Best effort only: the PID can still be recycled between the check and kill().
+        return ProcStatParser::read(key.pid, stat) && stat.starttime == key.starttime && kill(key.pid, sig) == 0;
+    }
+    int fd = pidfdOpen(key.pid);
+    if (fd == -1) return false;
+    bool sent = ProcStatParser::read(key.pid, stat) && stat.starttime == key.starttime && pidfdSendSignal(fd, sig) == 0;
+    close(fd);
+    return sent;
+}
+
+void PidfdWatcher::run() {
+    struct epoll_event events[64];
+    std::vector<std::pair<int, unsigned long long>> exited;
+    while (running) {
+        int n = epoll_wait(epoll_fd, events, 64, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        exited.clear();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.u64 == UINT64_MAX) continue;
+                int pid = static_cast<int>(events[i].data.u64 & 0xffffffffu);
+                uint32_t serial = static_cast<uint32_t>(events[i].data.u64 >> 32);
+                auto it = watches.find(pid);
+                if (it == watches.end() || it->second.serial != serial) continue; // Unwatched meanwhile
+                exited.emplace_back(pid, it->second.starttime);
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+                close(it->second.fd);
+                watches.erase(it);
+            }
+        }
+        // Outside the lock: the handler may call back into unwatch().
+        for (const auto& process : exited) handler(process.first, process.second);
+    }
+}
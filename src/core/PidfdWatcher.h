@@ -0,0 +1,64 @@
+#ifndef PIDFD_WATCHER_H
+#define PIDFD_WATCHER_H
+
+#include "ProcessKey.h"
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+// Holds a pidfd for each watched process. Signals go through the pidfd, so
+// they can never reach a process that recycled the PID, and every pidfd
+// sits in one epoll set so an exit is reported as soon as it happens
+// rather than at the next /proc scan. Needs Linux 5.3 or later.
+class PidfdWatcher {
+public:
+    PidfdWatcher();
+    ~PidfdWatcher();
+    PidfdWatcher(const PidfdWatcher&) = delete;
+    PidfdWatcher& operator=(const PidfdWatcher&) = delete;
+
+    // handler runs on the watcher thread with the (pid, starttime) that exited.
+    bool start(std::function<void(int pid, unsigned long long starttime)> handler);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Opens a pidfd and checks it still refers to the process that started
+    // at starttime. False if the process is gone, pidfds are unsupported or
+    // the fd budget is spent; such processes are left to the periodic scan.
+    bool watch(int pid, unsigned long long starttime);
+    void unwatch(int pid);
+    bool isWatched(int pid) const;
+    size_t size() const;
+
+    // Signals through the held pidfd when it belongs to key, otherwise
+    // through a short-lived one; either way nothing is sent unless the PID
+    // still started at key.starttime. Falls back to kill() only on kernels
+    // without pidfds.
+    bool sendSignal(const ProcessKey& key, int sig);
+
+    static bool isSupported();
+
+private:
+    struct Watch {
+        int fd;
+        unsigned long long starttime;
+        uint32_t serial; // Tells a rewatched PID apart from the one epoll reported
+    };
+
+    void run();
+
+    int epoll_fd;
+    int wake_fd;
+    std::thread waiter;
+    std::atomic<bool> running;
+    mutable std::mutex mtx;
+    std::unordered_map<int, Watch> watches;
+    uint32_t nextSerial;
+    size_t budget; // Max pidfds held at once, from RLIMIT_NOFILE
+    std::function<void(int pid, unsigned long long starttime)> handler;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "PolicyClassifier.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Packs (values[i] > threshold) or (values[i] < threshold) into 64-bit words.
+template <bool Greater>
+void compareDoubles(const double* values, size_t n, double threshold, uint64_t* words) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d limit = _mm256_set1_pd(threshold);
+    for (; i + 64 <= n; i += 64) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            __m256d v = _mm256_loadu_pd(values + i + j);
+            __m256d mask = Greater ? _mm256_cmp_pd(v, limit, _CMP_GT_OQ) : _mm256_cmp_pd(v, limit, _CMP_LT_OQ);
+            word |= static_cast<uint64_t>(_mm256_movemask_pd(mask)) << j;
+        }
+        words[i / 64] = word;
+    }
+#elif defined(__SSE2__)
+    const __m128d limit = _mm_set1_pd(threshold);
+    for (; i + 64 <= n; i += 64) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < 64; j += 2) {
+            __m128d v = _mm_loadu_pd(values + i + j);
+            __m128d mask = Greater ? _mm_cmpgt_pd(v, limit) : _mm_cmplt_pd(v, limit);
+            word |= static_cast<uint64_t>(_mm_movemask_pd(mask)) << j;
+        }
+        words[i / 64] = word;
+    }
+#endif
+    for (; i < n; ++i) {
+        bool hit = Greater ? values[i] > threshold : values[i] < threshold;
+        words[i / 64] |= static_cast<uint64_t>(hit) << (i % 64);
+    }
+}
+
+void compareLongs(const long* values, size_t n, long threshold, uint64_t* words) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    static_assert(sizeof(long) == 8, "AVX2 path assumes 64-bit long");
+    const __m256i limit = _mm256_set1_epi64x(threshold);
+    for (; i + 64 <= n; i += 64) {
+        uint64_t word = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + j));
+            __m256i mask = _mm256_cmpgt_epi64(v, limit);
+            word |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))) << j;
+        }
+        words[i / 64] = word;
+    }
+#endif
+    for (; i < n; ++i) {
+        words[i / 64] |= static_cast<uint64_t>(values[i] > threshold) << (i % 64);
+    }
+}
+
+}
+
+size_t DecisionBitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) total += static_cast<size_t>(__builtin_popcountll(word));
+    return total;
+}
+
+DecisionBitmap DecisionBitmap::operator&(const DecisionBitmap& other) const {
+    DecisionBitmap result(bits);
+    for (size_t w = 0; w < words.size(); ++w) result.words[w] = words[w] & other.words[w];
+    return result;
+}
+
+DecisionBitmap DecisionBitmap::operator|(const DecisionBitmap& other) const {
+    DecisionBitmap result(bits);
+    for (size_t w = 0; w < words.size(); ++w) result.words[w] = words[w] | other.words[w];
+    return result;
+}
+
+DecisionBitmap DecisionBitmap::andNot(const DecisionBitmap& other) const {
+    DecisionBitmap result(bits);
+    for (size_t w = 0; w < words.size(); ++w) result.words[w] = words[w] & ~other.words[w];
+    return result;
+}
+
+DecisionBitmap PolicyClassifier::above(const std::vector<double>& values, double threshold) {
+    DecisionBitmap result(values.size());
+    compareDoubles<true>(values.data(), values.size(), threshold, result.data().data());
+    return result;
+}
+
+DecisionBitmap PolicyClassifier::below(const std::vector<double>& values, double threshold) {
+    DecisionBitmap result(values.size());
+    compareDoubles<false>(values.data(), values.size(), threshold, result.data().data());
+    return result;
+}
+
+DecisionBitmap PolicyClassifier::above(const std::vector<long>& values, long threshold) {
+    DecisionBitmap result(values.size());
+    compareLongs(values.data(), values.size(), threshold, result.data().data());
+    return result;
+}
+
+DecisionBitmap PolicyClassifier::all(size_t size) {
+    DecisionBitmap result(size);
+    for (size_t i = 0; i < size; ++i) result.set(i);
+    return result;
+}
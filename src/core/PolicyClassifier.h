@@ -0,0 +1,50 @@
+#ifndef POLICY_CLASSIFIER_H
+#define POLICY_CLASSIFIER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One bit per snapshot row; policies iterate only the rows whose bit is set.
+class DecisionBitmap {
+public:
+    DecisionBitmap() : bits(0) {}
+    explicit DecisionBitmap(size_t size) : words((size + 63) / 64, 0), bits(size) {}
+
+    size_t size() const { return bits; }
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void set(size_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+    size_t count() const;
+    std::vector<uint64_t>& data() { return words; }
+    const std::vector<uint64_t>& data() const { return words; }
+
+    DecisionBitmap operator&(const DecisionBitmap& other) const;
+    DecisionBitmap operator|(const DecisionBitmap& other) const;
+    DecisionBitmap andNot(const DecisionBitmap& other) const;
+
+    template <typename F>
+    void forEachSet(F fn) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (uint64_t word = words[w]; word; word &= word - 1) {
+                fn(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits;
+};
+
+// Threshold passes over snapshot columns. x86-64 builds compare two (SSE2)
+// or four (AVX2) values per instruction and pack the results straight
+// into bitmap words; other targets use the scalar loop.
+class PolicyClassifier {
+public:
+    static DecisionBitmap above(const std::vector<double>& values, double threshold);
+    static DecisionBitmap below(const std::vector<double>& values, double threshold);
+    static DecisionBitmap above(const std::vector<long>& values, long threshold);
+    static DecisionBitmap all(size_t size);
+};
+
+#endif
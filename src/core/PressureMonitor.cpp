@@ -0,0 +1,151 @@
+#include "PressureMonitor.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const PRESSURE_PATHS[3] = {"/proc/pressure/cpu", "/proc/pressure/memory", "/proc/pressure/io"};
+
+// Parses "some avg10=0.12 avg60=0.05 avg300=0.01 total=12345".
+bool parseLine(const char* p, const char* eol, PressureLine& out) {
+    int fields = 0;
+    while (p < eol) {
+        const char* eq = static_cast<const char*>(memchr(p, '=', eol - p));
+        if (!eq) break;
+        char* next = nullptr;
+        if (eq - p == 5 && memcmp(p, "avg10", 5) == 0) {
+            out.avg10 = strtod(eq + 1, &next);
+        } else if (eq - p == 5 && memcmp(p, "avg60", 5) == 0) {
+            out.avg60 = strtod(eq + 1, &next);
+        } else if (eq - p == 6 && memcmp(p, "avg300", 6) == 0) {
+            out.avg300 = strtod(eq + 1, &next);
+        } else if (eq - p == 5 && memcmp(p, "total", 5) == 0) {
+            out.total_us = strtoull(eq + 1, &next, 10);
+        } else {
+            next = const_cast<char*>(eq + 1);
+        }
+        ++fields;
+        p = next;
+        while (p < eol && *p == ' ') ++p;
+    }
+    return fields >= 4;
+}
+
+}
+
+const unsigned int PressureMonitor::CPU_STALL;
+const unsigned int PressureMonitor::MEMORY_STALL;
+const unsigned int PressureMonitor::IO_STALL;
+const unsigned int PressureMonitor::WOKEN;
+
+PressureMonitor::PressureMonitor() {
+    for (int i = 0; i < 3; ++i) statFds[i] = open(PRESSURE_PATHS[i], O_RDONLY | O_CLOEXEC);
+    if (statFds[0] == -1) Logger::log("PSI unavailable; scheduling on a fixed interval");
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+PressureMonitor::~PressureMonitor() {
+    clearTriggers();
+    for (int fd : statFds) {
+        if (fd != -1) close(fd);
+    }
+    if (wake_fd != -1) close(wake_fd);
+}
+
+const char* PressureMonitor::name(PressureResource resource) {
+    switch (resource) {
+    case PressureResource::CPU: return "cpu";
+    case PressureResource::MEMORY: return "memory";
+    case PressureResource::IO: return "io";
+    }
+    return "unknown";
+}
+
+bool PressureMonitor::parse(const char* buf, size_t len, PressureStats& out) {
+    memset(&out, 0, sizeof(out));
+    const char* end = buf + len;
+    bool some = false;
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        if (eol - line > 5 && memcmp(line, "some ", 5) == 0) some = parseLine(line + 5, eol, out.some);
+        if (eol - line > 5 && memcmp(line, "full ", 5) == 0) parseLine(line + 5, eol, out.full);
+        line = eol + 1;
+    }
+    return some;
+}
+
+bool PressureMonitor::read(PressureSnapshot& out) {
+    PressureStats* stats[3] = {&out.cpu, &out.memory, &out.io};
+    bool ok = true;
+    for (int i = 0; i < 3; ++i) {
+        char buf[256];
+        ssize_t n = (statFds[i] == -1) ? -1 : pread(statFds[i], buf, sizeof(buf) - 1, 0);
+        if (n <= 0) {
+            memset(stats[i], 0, sizeof(PressureStats));
+            ok = false;
+            continue;
+        }
+        ok = parse(buf, static_cast<size_t>(n), *stats[i]) && ok;
+    }
+    return ok;
+}
+
+bool PressureMonitor::addTrigger(PressureResource resource, bool full, unsigned int threshold_us, unsigned int window_us) {
+    int fd = open(PRESSURE_PATHS[static_cast<int>(resource)], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) return false;
+    char spec[64];
+    int len = snprintf(spec, sizeof(spec), "%s %u %u", full ? "full" : "some", threshold_us, window_us);
+    // The terminating NUL is part of the write, as the kernel expects.
+    if (write(fd, spec, static_cast<size_t>(len) + 1) < 0) {
+        Logger::log(std::string("PSI trigger '") + spec + "' on " + name(resource) + " rejected: " + strerror(errno));
+        close(fd);
+        return false;
+    }
+    triggers.push_back(Trigger{fd, resource});
+    return true;
+}
+
+void PressureMonitor::clearTriggers() {
+    for (const auto& trigger : triggers) close(trigger.fd);
+    triggers.clear();
+}
+
+unsigned int PressureMonitor::wait(int timeout_ms) {
+    struct pollfd fds[8];
+    size_t count = 0;
+    fds[count++] = pollfd{wake_fd, POLLIN, 0};
+    for (size_t i = 0; i < triggers.size() && count < 8; ++i) fds[count++] = pollfd{triggers[i].fd, POLLPRI, 0};
+
+    int ready = poll(fds, count, timeout_ms);
+    if (ready <= 0) return 0; // Timeout, or EINTR treated as a timeout
+    unsigned int stalls = 0;
+    if (fds[0].revents & POLLIN) {
+        uint64_t value;
+        if (::read(wake_fd, &value, sizeof(value)) < 0) {
+            Logger::log("Failed to drain PSI wakeup");
+        }
+        stalls |= WOKEN;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        if (fds[i].revents & POLLERR) continue; // The monitored cgroup or file went away
+        if (fds[i].revents & POLLPRI) stalls |= 1u << static_cast<int>(triggers[i - 1].resource);
+    }
+    return stalls;
+}
+
+void PressureMonitor::wake() {
+    uint64_t one = 1;
+    if (wake_fd != -1 && write(wake_fd, &one, sizeof(one)) < 0) {
+        Logger::log("Failed to wake PSI wait");
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef PRESSURE_MONITOR_H
+#define PRESSURE_MONITOR_H
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+enum class PressureResource { CPU = 0, MEMORY = 1, IO = 2 };
+
+// One line of a /proc/pressure file: share of wall time (%) in which some
+// (or all, for "full") runnable tasks were stalled on the resource.
+struct PressureLine {
+    double avg10;
+    double avg60;
+    double avg300;
+    unsigned long long total_us;
+};
+
+struct PressureStats {
+    PressureLine some;
+    PressureLine full; // Zero for CPU on kernels that do not report it
+};
+
+struct PressureSnapshot {
+    PressureStats cpu;
+    PressureStats memory;
+    PressureStats io;
+};
+
+// Pressure stall information (PSI). read() preads the three files through
+// held fds; triggers are separate fds on which the kernel raises POLLPRI
+// when stall time within a window crosses a threshold, so wait() sleeps
+// until either a stall or the timeout. Needs CONFIG_PSI (Linux 4.20+,
+// triggers 5.2+).
+class PressureMonitor {
+public:
+    // Bits returned by wait().
+    static const unsigned int CPU_STALL = 1u << 0;
+    static const unsigned int MEMORY_STALL = 1u << 1;
+    static const unsigned int IO_STALL = 1u << 2;
+    static const unsigned int WOKEN = 1u << 3;
+
+    PressureMonitor();
+    ~PressureMonitor();
+    PressureMonitor(const PressureMonitor&) = delete;
+    PressureMonitor& operator=(const PressureMonitor&) = delete;
+
+    bool isSupported() const { return statFds[0] != -1; }
+    bool read(PressureSnapshot& out);
+
+    // "some" (full == false) or "full" stall of threshold_us within window_us.
+    bool addTrigger(PressureResource resource, bool full, unsigned int threshold_us, unsigned int window_us);
+    void clearTriggers();
+    bool hasTriggers() const { return !triggers.empty(); }
+
+    // Blocks until a trigger fires, wake() is called or timeout_ms passes;
+    // returns the stall bits (0 on timeout). Triggers must not be changed
+    // while another thread is inside wait().
+    unsigned int wait(int timeout_ms);
+    void wake();
+
+    static bool parse(const char* buf, size_t len, PressureStats& out);
+    static const char* name(PressureResource resource);
+
+private:
+    struct Trigger {
+        int fd;
+        PressureResource resource;
+    };
+
+    int statFds[3];
+    int wake_fd;
+    std::vector<Trigger> triggers;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "ProcEventListener.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ProcEventListener::ProcEventListener() : sock(-1), wake_fd(-1), running(false), overrun(false) {}
+
+ProcEventListener::~ProcEventListener() {
+    stop();
+}
+
+bool ProcEventListener::start(std::function<void(const ProcEvent&)> handler) {
+    if (running) return true;
+    stop(); // Reaps a listener that gave up on a poll error
+    sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock == -1) {
+        Logger::log("Proc connector unavailable: " + std::string(strerror(errno)));
+        return false;
+    }
+    int rcvbuf = 4 * 1024 * 1024; // Absorb fork storms between wakeups
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1 || !subscribe(true)) {
+        Logger::log("Proc connector subscription failed: " + std::string(strerror(errno)));
+        close(sock);
+        sock = -1;
+        return false;
+    }
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd == -1) {
+        // Without it stop() could not wake the listener out of poll().
+        Logger::log("Proc connector wakeup eventfd failed: " + std::string(strerror(errno)));
+        subscribe(false);
+        close(sock);
+        sock = -1;
+        return false;
+    }
+    this->handler = std::move(handler);
+    running = true;
+    listener = std::thread(&ProcEventListener::listen, this);
+    Logger::log("Proc connector event source started");
+    return true;
+}
+
+// Also tears down after the listener thread has quit on its own, which
+// leaves running false but the sockets open.
+void ProcEventListener::stop() {
+    if (sock == -1) return;
+    running = false;
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) {
+        Logger::log("Failed to wake proc connector listener");
+    }
+    if (listener.joinable()) listener.join();
+    subscribe(false);
+    close(sock);
+    close(wake_fd);
+    sock = -1;
+    wake_fd = -1;
+    Logger::log("Proc connector event source stopped");
+}
+
+bool ProcEventListener::subscribe(bool enable) {
+    alignas(struct nlmsghdr) char request[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    memset(request, 0, sizeof(request));
+    struct nlmsghdr* header = reinterpret_cast<struct nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = getpid();
+    struct cn_msg* message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(enum proc_cn_mcast_op);
+    enum proc_cn_mcast_op op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    memcpy(message->data, &op, sizeof(op));
+    return send(sock, request, header->nlmsg_len, 0) != -1;
+}
+
+void ProcEventListener::listen() {
+    alignas(struct nlmsghdr) char buffer[8192];
+    struct pollfd fds[2] = {{sock, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    while (running) {
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) continue;
+            // No more events will arrive; isRunning() now sends the caller
+            // back to full scans.
+            Logger::log("Proc connector poll failed: " + std::string(strerror(errno)));
+            running = false;
+            break;
+        }
+        if (fds[1].revents) break;
+        struct sockaddr_nl sender;
+        socklen_t sender_len = sizeof(sender);
+        ssize_t len = recvfrom(sock, buffer, sizeof(buffer), MSG_DONTWAIT, reinterpret_cast<struct sockaddr*>(&sender),
+                               &sender_len);
+        if (len == -1) {
+            if (errno == ENOBUFS) overrun = true; // Kernel dropped events; caller should rescan
+            continue;
+        }
+        // Any local process can send to a netlink socket; only the kernel
+        // (port 0) speaks for the proc connector.
+        if (sender_len != sizeof(sender) || sender.nl_family != AF_NETLINK || sender.nl_pid != 0) continue;
+        for (struct nlmsghdr* header = reinterpret_cast<struct nlmsghdr*>(buffer); NLMSG_OK(header, static_cast<unsigned int>(len));
+             header = NLMSG_NEXT(header, len)) {
+            if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) continue;
+            if (header->nlmsg_len < NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(struct proc_event))) continue;
+            struct cn_msg* message = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+            if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) continue;
+            const struct proc_event* event = reinterpret_cast<const struct proc_event*>(message->data);
+            ProcEvent out;
+            switch (event->what) {
+                case proc_event::PROC_EVENT_FORK:
+                    // Thread creation also reports FORK; only new thread groups matter here.
+                    if (event->event_data.fork.child_pid != event->event_data.fork.child_tgid) continue;
+                    out = ProcEvent{ProcEvent::FORK, event->event_data.fork.child_tgid, event->event_data.fork.parent_tgid};
+                    break;
+                case proc_event::PROC_EVENT_EXEC:
+                    out = ProcEvent{ProcEvent::EXEC, event->event_data.exec.process_tgid, 0};
+                    break;
+                case proc_event::PROC_EVENT_EXIT:
+                    if (event->event_data.exit.process_pid != event->event_data.exit.process_tgid) continue;
+                    out = ProcEvent{ProcEvent::EXIT, event->event_data.exit.process_tgid, 0};
+                    break;
+                default:
+                    continue;
+            }
+            handler(out);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef PROC_EVENT_LISTENER_H
+#define PROC_EVENT_LISTENER_H
+
+#include <functional>
+#include <thread>
+#include <atomic>
+
+struct ProcEvent {
+    enum Type { FORK, EXEC, EXIT };
+    Type type;
+    int pid;        // Thread-group id of the process the event is about
+    int parent_pid; // Only set for FORK
+};
+
+// Streams process-level fork/exec/exit events from the kernel's CN_PROC
+// netlink connector. Needs CAP_NET_ADMIN; start() returns false without it.
+class ProcEventListener {
+public:
+    ProcEventListener();
+    ~ProcEventListener();
+    bool start(std::function<void(const ProcEvent&)> handler);
+    void stop();
+    bool isRunning() const { return running; }
+    // True if the socket overflowed since the last call, i.e. events were lost.
+    bool takeOverrun() { return overrun.exchange(false); }
+
+private:
+    bool subscribe(bool enable);
+    void listen();
+
+    int sock;
+    int wake_fd;
+    std::thread listener;
+    std::atomic<bool> running;
+    std::atomic<bool> overrun;
+    std::function<void(const ProcEvent&)> handler;
+};
+
+#endif
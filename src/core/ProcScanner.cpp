@@ -0,0 +1,267 @@
+#include "ProcScanner.h"
+#include "UringProcReader.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct LinuxDirent64 {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+ssize_t readFileAt(int proc_fd, int pid, const char* name, char* buf, size_t size) {
+    char path[24];
+    snprintf(path, sizeof(path), "%d/%s", pid, name);
+    int fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = read(fd, buf, size);
+    close(fd);
+    return n;
+}
+
+void readWithSyscalls(int proc_fd, const int* pids, size_t count, bool read_io, ProcSample* out) {
+    char buf[ProcStatParser::BUFFER_SIZE];
+    for (size_t i = 0; i < count; ++i) {
+        ProcSample& sample = out[i];
+        sample.memory_usage = 0;
+        sample.read_bytes = 0;
+        sample.write_bytes = 0;
+        sample.counters_only = false;
+        sample.has_delays = false;
+        sample.has_schedstat = false;
+        sample.valid = ProcStatParser::readAt(proc_fd, pids[i], sample.stat);
+        if (!sample.valid) continue;
+        ssize_t n = readFileAt(proc_fd, pids[i], "statm", buf, sizeof(buf));
+        if (n > 0) sample.memory_usage = ProcScanner::parseStatm(buf, static_cast<size_t>(n));
+        n = readFileAt(proc_fd, pids[i], "schedstat", buf, sizeof(buf));
+        if (n > 0) ProcScanner::parseSchedstat(buf, static_cast<size_t>(n), sample);
+        if (!read_io) continue;
+        n = readFileAt(proc_fd, pids[i], "io", buf, sizeof(buf));
+        if (n > 0) ProcScanner::parseIo(buf, static_cast<size_t>(n), sample);
+    }
+}
+
+// One binary TASKSTATS reply per process for CPU and delays; current RSS is
+// not in taskstats (only its high-water mark), so statm is still read.
+bool readWithTaskstats(int proc_fd, const int* pids, size_t count, ProcSample* out) {
+    thread_local TaskstatsClient client; // One socket per scanning thread
+    if (!client.open()) return false;
+    static const long ticks_per_second = sysconf(_SC_CLK_TCK);
+    char buf[64];
+    TaskCounters counters;
+    for (size_t i = 0; i < count; ++i) {
+        ProcSample& sample = out[i];
+        sample.counters_only = true;
+        sample.read_bytes = 0;
+        sample.write_bytes = 0;
+        sample.memory_usage = 0;
+        sample.valid = client.queryTgid(pids[i], counters);
+        if (!sample.valid) continue;
+        sample.stat.pid = pids[i];
+        sample.stat.utime = counters.utime_us * ticks_per_second / 1000000;
+        sample.stat.stime = counters.stime_us * ticks_per_second / 1000000;
+        sample.cpu_delay_ns = counters.cpu_delay_ns;
+        sample.io_delay_ns = counters.blkio_delay_ns + counters.swapin_delay_ns;
+        sample.has_delays = true;
+        sample.run_ns = counters.cpu_run_ns;
+        sample.wait_ns = counters.cpu_delay_ns;
+        sample.timeslices = counters.cpu_count;
+        sample.has_schedstat = true;
+        ssize_t n = readFileAt(proc_fd, pids[i], "statm", buf, sizeof(buf));
+        if (n > 0) sample.memory_usage = ProcScanner::parseStatm(buf, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+void sampleRange(int proc_fd, ProcReaderBackend backend, bool read_io, bool counters_only, const int* pids, size_t count,
+                 ProcSample* out) {
+    if (counters_only && backend == ProcReaderBackend::TASKSTATS && readWithTaskstats(proc_fd, pids, count, out)) return;
+    if (backend == ProcReaderBackend::IO_URING) {
+        thread_local UringProcReader ring; // One ring per scanning thread
+        if (ring.read(proc_fd, pids, count, read_io, out)) return;
+    }
+    readWithSyscalls(proc_fd, pids, count, read_io, out);
+}
+
+// Shared between the caller and the pool helpers; helpers that start after
+// every chunk is claimed find nothing to do and exit.
+struct ScanWork {
+    int proc_fd;
+    ProcReaderBackend backend;
+    bool read_io;
+    bool counters_only;
+    const int* pids;
+    ProcSample* out;
+    size_t count;
+    size_t chunks;
+    std::atomic<size_t> next{0};
+    size_t finished = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    void run() {
+        size_t chunk;
+        while ((chunk = next.fetch_add(1)) < chunks) {
+            size_t begin = chunk * ProcScanner::CHUNK_SIZE;
+            sampleRange(proc_fd, backend, read_io, counters_only, pids + begin, std::min(ProcScanner::CHUNK_SIZE, count - begin), out + begin);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (++finished == chunks) cv.notify_all();
+        }
+    }
+};
+
+}
+
+const size_t ProcScanner::CHUNK_SIZE;
+
+ProcScanner::ProcScanner()
+    : threadPool(nullptr), backend(ProcReaderBackend::SYSCALL), read_io(false), direntBuffer(64 * 1024) {
+    proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd == -1) Logger::log("Failed to open /proc");
+}
+
+ProcScanner::~ProcScanner() {
+    if (proc_fd != -1) close(proc_fd);
+}
+
+bool ProcScanner::listPids(std::vector<int>& pids) {
+    if (proc_fd == -1 || lseek(proc_fd, 0, SEEK_SET) == -1) {
+        pids.clear();
+        return false;
+    }
+    return listNumericEntries(proc_fd, direntBuffer, pids);
+}
+
+bool ProcScanner::listNumericEntries(int dir_fd, std::vector<char>& buffer, std::vector<int>& out) {
+    out.clear();
+    while (true) {
+        long bytes = syscall(SYS_getdents64, dir_fd, buffer.data(), buffer.size());
+        if (bytes == -1) return false;
+        if (bytes == 0) break;
+        for (long offset = 0; offset < bytes;) {
+            const LinuxDirent64* ent = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+            offset += ent->d_reclen;
+            const char* name = ent->d_name;
+            if (*name < '0' || *name > '9') continue;
+            int id = 0;
+            while (*name >= '0' && *name <= '9') id = id * 10 + (*name++ - '0');
+            out.push_back(id);
+        }
+    }
+    return true;
+}
+
+void ProcScanner::sample(const int* pids, size_t count, ProcSample* out) {
+    sampleChunks(pids, count, out, false);
+}
+
+void ProcScanner::sampleCounters(const int* pids, size_t count, ProcSample* out) {
+    sampleChunks(pids, count, out, backend == ProcReaderBackend::TASKSTATS);
+}
+
+void ProcScanner::sampleChunks(const int* pids, size_t count, ProcSample* out, bool counters_only) {
+    size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (!threadPool || chunks < 2) {
+        sampleRange(proc_fd, backend, read_io, counters_only, pids, count, out);
+        return;
+    }
+    auto work = std::make_shared<ScanWork>();
+    work->proc_fd = proc_fd;
+    work->backend = backend;
+    work->read_io = read_io;
+    work->counters_only = counters_only;
+    work->pids = pids;
+    work->out = out;
+    work->count = count;
+    work->chunks = chunks;
+    size_t helpers = std::min(threadPool->size(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        threadPool->enqueue([work]() { work->run(); });
+    }
+    work->run();
+    {
+        std::unique_lock<std::mutex> lock(work->mtx);
+        work->cv.wait(lock, [&work] { return work->finished == work->chunks; });
+    }
+}
+
+bool ProcScanner::sampleOne(int pid, ProcSample& out) {
+    readWithSyscalls(proc_fd, &pid, 1, read_io, &out); // Not worth a ring round-trip
+    return out.valid;
+}
+
+void ProcScanner::setBackend(ProcReaderBackend requested) {
+    if (requested == ProcReaderBackend::IO_URING && !UringProcReader::isSupported()) {
+        Logger::log("io_uring reader unavailable, using plain syscalls");
+        requested = ProcReaderBackend::SYSCALL;
+    }
+    if (requested == ProcReaderBackend::TASKSTATS) {
+        if (!TaskstatsClient::isSupported()) {
+            Logger::log("TASKSTATS unavailable (needs CAP_NET_ADMIN), using plain syscalls");
+            requested = ProcReaderBackend::SYSCALL;
+        } else if (!exitStats.isOpen() && !(exitStats.open() && exitStats.registerExitListener())) {
+            Logger::log("TASKSTATS exit records unavailable; exits are found by scans");
+        }
+    }
+    backend = requested;
+}
+
+// statm is "size resident shared text lib data dt", all in pages; the
+// first field is virtual size, which says nothing about memory in use.
+long ProcScanner::parseStatm(const char* buf, size_t len) {
+    static const long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    size_t i = 0;
+    while (i < len && buf[i] >= '0' && buf[i] <= '9') ++i;
+    if (i < len && buf[i] == ' ') ++i;
+    long pages = 0;
+    for (; i < len && buf[i] >= '0' && buf[i] <= '9'; ++i) pages = pages * 10 + (buf[i] - '0');
+    return pages * page_kb;
+}
+
+void ProcScanner::parseIo(const char* buf, size_t len, ProcSample& out) {
+    const char* end = buf + len;
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        unsigned long long* field = nullptr;
+        if (eol - line > 12 && memcmp(line, "read_bytes: ", 12) == 0) field = &out.read_bytes;
+        if (eol - line > 13 && memcmp(line, "write_bytes: ", 13) == 0) field = &out.write_bytes;
+        if (field) {
+            const char* p = static_cast<const char*>(memchr(line, ' ', eol - line)) + 1;
+            unsigned long long value = 0;
+            for (; p < eol && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+            *field = value;
+        }
+        line = eol + 1;
+    }
+}
+
+bool ProcScanner::parseSchedstat(const char* buf, size_t len, ProcSample& out) {
+    const char* end = buf + len;
+    unsigned long long* fields[] = {&out.run_ns, &out.wait_ns, &out.timeslices};
+    const char* p = buf;
+    out.has_schedstat = false;
+    for (unsigned long long* field : fields) {
+        while (p < end && *p == ' ') ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        unsigned long long value = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+        *field = value;
+    }
+    out.has_schedstat = true;
+    return true;
+}
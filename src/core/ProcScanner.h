@@ -0,0 +1,79 @@
+#ifndef PROC_SCANNER_H
+#define PROC_SCANNER_H
+
+#include "ProcStatParser.h"
+#include "ThreadPool.h"
+#include "TaskstatsClient.h"
+#include <vector>
+
+struct ProcSample {
+    ProcStat stat;
+    long memory_usage;              // Resident KB
+    unsigned long long read_bytes;  // From /proc/[pid]/io when enabled
+    unsigned long long write_bytes;
+    unsigned long long cpu_delay_ns;   // Delay accounting totals, TASKSTATS only
+    unsigned long long io_delay_ns;    // Block I/O plus swap-in
+    bool has_delays;
+    // Scheduler statistics: /proc/[pid]/schedstat (main thread only) or,
+    // for counters_only samples, the same counters summed over the group.
+    unsigned long long run_ns;         // Time on a CPU
+    unsigned long long wait_ns;        // Time runnable on a run queue
+    unsigned long long timeslices;     // Times scheduled onto a CPU
+    bool has_schedstat;
+    bool counters_only;             // Only pid, utime and stime of stat are set
+    bool valid;                     // false if the process vanished while being read
+};
+
+enum class ProcReaderBackend { SYSCALL, IO_URING, TASKSTATS };
+
+// Reads /proc through a held O_DIRECTORY fd: PIDs are listed in bulk with
+// getdents64 and per-PID files are opened with openat. Large PID lists are
+// split into chunks and spread across a ThreadPool; the calling thread
+// works on chunks too, so it never blocks on a busy pool.
+class ProcScanner {
+public:
+    static const size_t CHUNK_SIZE = 256;
+
+    ProcScanner();
+    ~ProcScanner();
+    ProcScanner(const ProcScanner&) = delete;
+    ProcScanner& operator=(const ProcScanner&) = delete;
+
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+    // Falls back to SYSCALL when io_uring is not usable on this kernel.
+    void setBackend(ProcReaderBackend requested);
+    ProcReaderBackend getBackend() const { return backend; }
+    void setReadIO(bool enabled) { read_io = enabled; }
+    bool listPids(std::vector<int>& pids);
+    void sample(const int* pids, size_t count, ProcSample* out);
+    bool sampleOne(int pid, ProcSample& out);
+    // Counters of processes whose identity is already known. The TASKSTATS
+    // backend answers these over netlink (counters_only samples); other
+    // backends do a full sample.
+    void sampleCounters(const int* pids, size_t count, ProcSample* out);
+    // Thread groups whose TASKSTATS exit records arrived since the last call.
+    void drainExits(std::vector<int>& tgids) { exitStats.drainExits(tgids); }
+
+    int procFd() const { return proc_fd; }
+
+    // Lists the numeric entries of an open directory (PIDs of /proc, TIDs
+    // of /proc/[pid]/task) with getdents64.
+    static bool listNumericEntries(int dir_fd, std::vector<char>& buffer, std::vector<int>& out);
+    // Resident KB from the second statm field, in the system's page size.
+    static long parseStatm(const char* buf, size_t len);
+    static void parseIo(const char* buf, size_t len, ProcSample& out);
+    // "run_ns wait_ns timeslices"; false if the line is malformed.
+    static bool parseSchedstat(const char* buf, size_t len, ProcSample& out);
+
+private:
+    void sampleChunks(const int* pids, size_t count, ProcSample* out, bool counters_only);
+
+    int proc_fd;
+    ThreadPool* threadPool;
+    ProcReaderBackend backend;
+    bool read_io;
+    std::vector<char> direntBuffer;
+    TaskstatsClient exitStats; // Registered for exit records with the TASKSTATS backend
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "ProcessClassifier.h"
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const unsigned int ProcessClassifier::PF_KTHREAD;
+const uid_t ProcessClassifier::FIRST_USER_UID;
+
+ProcessClassifier::ProcessClassifier() : self_pid(getpid()) {}
+
+void ProcessClassifier::setExclusions(const std::vector<std::string>& names) {
+    exclusions = names;
+    std::sort(exclusions.begin(), exclusions.end());
+}
+
+ProcessClass ProcessClassifier::classify(int proc_fd, const ProcStat& stat, const std::string& cgroup_path) const {
+    uid_t uid = 0;
+    char path[16];
+    snprintf(path, sizeof(path), "%d", stat.pid);
+    struct stat st;
+    if (fstatat(proc_fd, path, &st, 0) == 0) uid = st.st_uid;
+    return classify(stat, uid, cgroup_path);
+}
+
+// Kernel threads first (PF_KTHREAD, or kthreadd and its children), then the
+// exclusion list and system-owned processes. User processes are placed by
+// their systemd slice where one exists; a process on a terminal is
+// FOREGROUND while its group owns the terminal and BACKGROUND otherwise.
+ProcessClass ProcessClassifier::classify(const ProcStat& stat, uid_t uid, const std::string& cgroup_path) const {
+    if ((stat.flags & PF_KTHREAD) || stat.pid == 2 || stat.ppid == 2) return ProcessClass::KERNEL;
+    if (stat.pid == 1 || stat.pid == self_pid || isExcluded(stat.comm)) return ProcessClass::SYSTEM;
+    if (uid < FIRST_USER_UID) return ProcessClass::SYSTEM;
+    if (cgroup_path.find("/system.slice") != std::string::npos ||
+        cgroup_path.find("/init.scope") != std::string::npos) {
+        return ProcessClass::SYSTEM;
+    }
+    if (cgroup_path.find("/background.slice") != std::string::npos) return ProcessClass::BACKGROUND;
+    if (stat.tty_nr != 0) return (stat.tpgid == stat.pgrp) ? ProcessClass::FOREGROUND : ProcessClass::BACKGROUND;
+    if (cgroup_path.find("/app.slice") != std::string::npos) return ProcessClass::FOREGROUND;
+    return ProcessClass::SESSION;
+}
+
+ProcessClass ProcessClassifier::jobControlClass(ProcessClass current, const ProcStat& stat, const std::string& cgroup_path) {
+    if (current != ProcessClass::FOREGROUND && current != ProcessClass::BACKGROUND) return current;
+    if (stat.tty_nr == 0 || cgroup_path.find("/background.slice") != std::string::npos) return current;
+    return (stat.tpgid == stat.pgrp) ? ProcessClass::FOREGROUND : ProcessClass::BACKGROUND;
+}
+
+const char* ProcessClassifier::name(ProcessClass cls) {
+    switch (cls) {
+    case ProcessClass::KERNEL: return "kernel";
+    case ProcessClass::SYSTEM: return "system";
+    case ProcessClass::SESSION: return "session";
+    case ProcessClass::FOREGROUND: return "foreground";
+    case ProcessClass::BACKGROUND: return "background";
+    }
+    return "unknown";
+}
+
+bool ProcessClassifier::isExcluded(const char* comm) const {
+    return std::binary_search(exclusions.begin(), exclusions.end(), std::string(comm));
+}
@@ -0,0 +1,47 @@
+#ifndef PROCESS_CLASSIFIER_H
+#define PROCESS_CLASSIFIER_H
+
+#include "ProcStatParser.h"
+#include <vector>
+#include <string>
+#include <sys/types.h>
+
+// What kind of process a PID is, decided once when it is first seen (and
+// again on exec; terminal jobs on every sample). Only SESSION, FOREGROUND and BACKGROUND processes are
+// handed to the scheduling policies; kernel threads, system services and
+// the scheduler itself are left alone.
+enum class ProcessClass : unsigned char { KERNEL, SYSTEM, SESSION, FOREGROUND, BACKGROUND };
+
+class ProcessClassifier {
+public:
+    static const unsigned int PF_KTHREAD = 0x00200000;
+    static const uid_t FIRST_USER_UID = 1000;
+
+    ProcessClassifier();
+
+    // comm names that are always treated as SYSTEM.
+    void setExclusions(const std::vector<std::string>& names);
+    // Reads the owner of the process relative to an open /proc fd; the
+    // cgroup path comes from the process's identity.
+    ProcessClass classify(int proc_fd, const ProcStat& stat, const std::string& cgroup_path) const;
+    // Decision from already gathered inputs; cgroup_path is the cgroup v2
+    // path ("/user.slice/...") or empty when unknown.
+    ProcessClass classify(const ProcStat& stat, uid_t uid, const std::string& cgroup_path) const;
+
+    // Job control (fg, bg, ^Z) moves a terminal's foreground group without
+    // an exec, so the tty part of classify() is re-run on each sampled stat:
+    // returns current with FOREGROUND/BACKGROUND re-decided where the
+    // terminal decided it.
+    static ProcessClass jobControlClass(ProcessClass current, const ProcStat& stat, const std::string& cgroup_path);
+
+    static bool isActionable(ProcessClass cls) { return cls >= ProcessClass::SESSION; }
+    static const char* name(ProcessClass cls);
+
+private:
+    bool isExcluded(const char* comm) const;
+
+    std::vector<std::string> exclusions; // Sorted
+    int self_pid;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef PROCESS_KEY_H
+#define PROCESS_KEY_H
+
+#include <cstddef>
+#include <functional>
+
+// A process is identified by (pid, starttime); a recycled PID gets a new
+// starttime and therefore a fresh slot.
+struct ProcessKey {
+    int pid;
+    unsigned long long starttime;
+
+    bool operator==(const ProcessKey& other) const { return pid == other.pid && starttime == other.starttime; }
+};
+
+struct ProcessKeyHash {
+    size_t operator()(const ProcessKey& key) const {
+        return std::hash<unsigned long long>()((static_cast<unsigned long long>(key.pid) << 40) ^ key.starttime);
+    }
+};
+
+#endif
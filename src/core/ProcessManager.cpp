@@ -1,28 +1,123 @@
 #include "ProcessManager.h"
 #include "Logger.h"
 #include "ProcessLock.h"
-#include <dirent.h>
+#include "PolicyClassifier.h"
+#include <algorithm>
 #include <fstream>
-#include <sstream>
 #include <sys/types.h>
+#include <sys/resource.h>
 #include <signal.h>
 #include <sched.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 
-void ProcessManager::adjustPriorities(const SchedulerConfig& config) {
+ProcessManager::ProcessManager() {
+    if (exitWatcher.start([this](int pid, unsigned long long starttime) { handleExit(pid, starttime); })) {
+        processTable.setExitWatcher(&exitWatcher);
+    }
+}
+
+ProcessSnapshot ProcessManager::captureSnapshot() {
+    std::lock_guard<std::mutex> guard(tableMtx);
+    auto now = std::chrono::steady_clock::now();
+    bool reconcile = !eventListener.isRunning() || eventListener.takeOverrun() ||
+                     now - lastFullScan >= std::chrono::milliseconds(reconcileIntervalMs.load());
+    if (reconcile) {
+        processTable.scan();
+        lastFullScan = now;
+    } else {
+        processTable.refresh();
+    }
+    ProcessSnapshot::Builder builder;
+    builder.reserve(processTable.size());
+    for (const auto& entry : processTable.entries()) {
+        if (!entry.live) continue;
+        ProcessInfo info;
+        info.pid = entry.key.pid;
+        info.start_time = entry.key.starttime;
+        info.identity = entry.identity;
+        info.cpu_usage = entry.cpu_usage;
+        info.memory_usage = entry.memory_usage;
+        info.cpu_delay = entry.cpu_delay;
+        info.io_delay = entry.io_delay;
+        info.wait_rate = entry.wait_rate;
+        info.sched_latency_us = entry.sched_latency_us;
+        info.has_schedstat = entry.has_schedstat;
+        info.flags = entry.flags;
+        info.process_class = entry.process_class;
+        info.group_id = 0; // Simplified group ID
+        builder.add(info);
+    }
+    if (processTable.appearedLastScan() || processTable.exitedLastScan()) {
+        Logger::log("Process table: " + std::to_string(processTable.appearedLastScan()) + " appeared, " +
+                    std::to_string(processTable.exitedLastScan()) + " exited, " +
+                    std::to_string(processTable.size()) + " tracked");
+    }
+    return builder.build(now);
+}
+
+void ProcessManager::adjustPriorities(const SchedulerConfig& config, const ProcessSnapshot& snapshot) {
+    std::lock_guard<std::mutex> guard(policyMtx);
+    DecisionBitmap busy = PolicyClassifier::above(snapshot.cpuUsage(), 50.0) & snapshot.actionable();
+    ThreadScope scope = parseThreadScope(config.thread_policy);
+    const auto& pids = snapshot.pids();
     ProcessLock lock;
-    auto processes = getRunningProcesses();
-    for (const auto& proc : processes) {
-        lock.lock(proc.pid);
-        int priority = (proc.cpu_usage > 50.0) ? config.priority_high : config.priority_low;
-        setPriority(proc.pid, priority);
-        setCPUAffinity(proc.pid, config.cpu_affinity_cores);
-        assignToCgroup(proc.pid, config);
-        lock.unlock(proc.pid);
-        Logger::log("Adjusted PID " + std::to_string(proc.pid) + " priority to " + std::to_string(priority));
+
+    nextBoostedTasks.clear();
+    busy.forEachSet([&](size_t i) {
+        int pid = pids[i];
+        lock.lock(pid);
+        for (const auto& thread : policyTargets(pid, snapshot.startTimes()[i], scope, config.hot_thread_threshold)) {
+            setPriority(thread.tid, config.priority_high);
+            setCPUAffinity(thread.tid, config.cpu_affinity_cores);
+            nextBoostedTasks.push_back(BoostedTask{pid, thread.tid, thread.starttime});
+        }
+        assignToCgroup(pid, config);
+        lock.unlock(pid);
+        Logger::log("Adjusted PID " + std::to_string(pid) + " priority to " + std::to_string(config.priority_high) +
+                    " (CPU " + std::to_string(snapshot.cpuUsage()[i]) + "%)");
+    });
+
+    // Tasks boosted last cycle that have cooled down go back to priority_low.
+    std::sort(nextBoostedTasks.begin(), nextBoostedTasks.end(),
+              [](const BoostedTask& a, const BoostedTask& b) { return a.tid < b.tid; });
+    for (const auto& task : boostedTasks) {
+        auto it = std::lower_bound(nextBoostedTasks.begin(), nextBoostedTasks.end(), task.tid,
+                                   [](const BoostedTask& boosted, int tid) { return boosted.tid < tid; });
+        if (it != nextBoostedTasks.end() && it->tid == task.tid) continue;
+        if (!threadSampler.isSameThread(task.pid, task.tid, task.starttime)) continue; // Exited or TID reused
+        setPriority(task.tid, config.priority_low);
+        Logger::log("Adjusted TID " + std::to_string(task.tid) + " of PID " + std::to_string(task.pid) +
+                    " priority to " + std::to_string(config.priority_low));
+    }
+    boostedTasks.swap(nextBoostedTasks);
+    threadSampler.endCycle();
+}
+
+// Targets are the main thread, every thread, or only threads whose own CPU%
+// crossed hot_threshold. Hot-thread selection needs two samples, so on the
+// first cycle a process is busy only its main thread is targeted.
+const std::vector<ThreadSample>& ProcessManager::policyTargets(int pid, unsigned long long start_time, ThreadScope scope,
+                                                               double hot_threshold) {
+    if (scope == ThreadScope::ALL_THREADS) {
+        threadSampler.listThreads(pid, threadTargets);
+    } else if (scope == ThreadScope::HOT_THREADS) {
+        threadSampler.sample(pid, threadTargets);
+        threadTargets.erase(std::remove_if(threadTargets.begin(), threadTargets.end(),
+                                           [hot_threshold](const ThreadSample& t) { return t.cpu_usage <= hot_threshold; }),
+                            threadTargets.end());
+    } else {
+        threadTargets.clear();
     }
+    if (threadTargets.empty()) threadTargets.push_back(ThreadSample{pid, start_time, 0.0});
+    return threadTargets;
+}
+
+ThreadScope ProcessManager::parseThreadScope(const std::string& scope) {
+    if (scope == "all_threads") return ThreadScope::ALL_THREADS;
+    if (scope == "hot_threads") return ThreadScope::HOT_THREADS;
+    return ThreadScope::PROCESS;
 }
 
 void ProcessManager::setPriority(int pid, int priority) {
@@ -31,6 +126,16 @@ void ProcessManager::setPriority(int pid, int priority) {
     }
 }
 
+void ProcessManager::placeProcess(int pid, const SchedulerConfig& config) {
+    {
+        std::lock_guard<std::mutex> guard(tableMtx);
+        const ProcessEntry* entry = processTable.find(pid);
+        if (!entry || !ProcessClassifier::isActionable(entry->process_class)) return;
+    }
+    setCPUAffinity(pid, config.cpu_affinity_cores);
+    assignToCgroup(pid, config);
+}
+
 void ProcessManager::setCPUAffinity(int pid, const std::vector<int>& cores) {
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
@@ -54,28 +159,28 @@ void ProcessManager::assignToCgroup(int pid, const SchedulerConfig& config) {
     Logger::log("Assigned PID " + std::to_string(pid) + " to cgroup with " + std::to_string(config.cgroup_cpu_shares) + " shares");
 }
 
-void ProcessManager::pauseProcess(int pid) {
+void ProcessManager::pauseProcess(int pid, unsigned long long start_time) {
     ProcessLock lock;
     lock.lock(pid);
-    kill(pid, SIGSTOP);
+    bool sent = exitWatcher.sendSignal(ProcessKey{pid, start_time}, SIGSTOP);
     lock.unlock(pid);
-    Logger::log("Paused PID " + std::to_string(pid));
+    if (sent) Logger::log("Paused PID " + std::to_string(pid));
 }
 
-void ProcessManager::resumeProcess(int pid) {
+void ProcessManager::resumeProcess(int pid, unsigned long long start_time) {
     ProcessLock lock;
     lock.lock(pid);
-    kill(pid, SIGCONT);
+    bool sent = exitWatcher.sendSignal(ProcessKey{pid, start_time}, SIGCONT);
     lock.unlock(pid);
-    Logger::log("Resumed PID " + std::to_string(pid));
+    if (sent) Logger::log("Resumed PID " + std::to_string(pid));
 }
 
-void ProcessManager::terminateProcess(int pid) {
+void ProcessManager::terminateProcess(int pid, unsigned long long start_time) {
     ProcessLock lock;
     lock.lock(pid);
-    kill(pid, SIGTERM);
+    bool sent = exitWatcher.sendSignal(ProcessKey{pid, start_time}, SIGTERM);
     lock.unlock(pid);
-    Logger::log("Terminated PID " + std::to_string(pid));
+    if (sent) Logger::log("Terminated PID " + std::to_string(pid));
 }
 
 void ProcessManager::createProcessGroup(int group_id) {
@@ -85,44 +190,58 @@ void ProcessManager::createProcessGroup(int group_id) {
 }
 
 std::vector<ProcessInfo> ProcessManager::getRunningProcesses() {
+    ProcessSnapshot snapshot = captureSnapshot();
     std::vector<ProcessInfo> processes;
-    DIR* dir = opendir("/proc");
-    struct dirent* ent;
-    while ((ent = readdir(dir)) != NULL) {
-        if (std::isdigit(ent->d_name[0])) {
-            int pid = std::stoi(ent->d_name);
-            ProcessInfo info;
-            info.pid = pid;
-            info.name = ent->d_name;
-            info.cpu_usage = calculateCPUUsage(pid);
-            info.memory_usage = getProcessMemory(pid);
-            info.group_id = 0; // Simplified group ID
-            processes.push_back(info);
-        }
-    }
-    closedir(dir);
+    processes.reserve(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i) processes.push_back(snapshot.at(i));
     return processes;
 }
 
-double ProcessManager::calculateCPUUsage(int pid) {
-    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
-    if (!stat.is_open()) return 0.0;
-    std::string line;
-    std::getline(stat, line);
-    std::istringstream iss(line);
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) tokens.push_back(token);
-    long utime = std::stol(tokens[13]);
-    long stime = std::stol(tokens[14]);
-    stat.close();
-    return (utime + stime) / 100.0; // Simplified CPU usage
-}
-
-long ProcessManager::getProcessMemory(int pid) {
-    std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
-    long size;
-    statm >> size;
-    statm.close();
-    return size * 4; // Pages to KB
-}
\ No newline at end of file
+void ProcessManager::setScanThreadPool(ThreadPool* pool) {
+    std::lock_guard<std::mutex> guard(tableMtx);
+    processTable.setThreadPool(pool);
+}
+
+void ProcessManager::configureScanner(const SchedulerConfig& config) {
+    std::lock_guard<std::mutex> guard(tableMtx);
+    ProcReaderBackend backend = ProcReaderBackend::SYSCALL;
+    if (config.proc_reader == "io_uring") backend = ProcReaderBackend::IO_URING;
+    if (config.proc_reader == "taskstats") backend = ProcReaderBackend::TASKSTATS;
+    processTable.setReaderBackend(backend);
+    processTable.setReadIO(config.sample_process_io);
+    processTable.setExclusions(config.excluded_processes);
+    SamplingPolicy sampling;
+    sampling.warm_interval = static_cast<unsigned int>(std::max(1, config.sampling_warm_interval));
+    sampling.idle_interval = static_cast<unsigned int>(std::max(1, config.sampling_idle_interval));
+    sampling.hot_threshold = config.sampling_hot_threshold;
+    processTable.setSamplingPolicy(sampling);
+}
+
+bool ProcessManager::enableEventSource(std::function<void(int pid)> onExec) {
+    execHandler = std::move(onExec);
+    return eventListener.start([this](const ProcEvent& event) { handleProcEvent(event); });
+}
+
+void ProcessManager::disableEventSource() {
+    eventListener.stop();
+}
+
+// Runs on the pidfd watcher thread as soon as a watched process exits.
+void ProcessManager::handleExit(int pid, unsigned long long starttime) {
+    std::lock_guard<std::mutex> guard(tableMtx);
+    processTable.remove(ProcessKey{pid, starttime});
+}
+
+void ProcessManager::handleProcEvent(const ProcEvent& event) {
+    {
+        std::lock_guard<std::mutex> guard(tableMtx);
+        if (event.type == ProcEvent::EXIT) {
+            processTable.remove(event.pid);
+        } else if (event.type == ProcEvent::EXEC) {
+            processTable.reclassify(event.pid);
+        } else {
+            processTable.track(event.pid);
+        }
+    }
+    if (event.type == ProcEvent::EXEC && execHandler) execHandler(event.pid);
+}
@@ -2,32 +2,73 @@
 #define PROCESS_MANAGER_H
 
 #include "types.h"
+#include "ProcessSnapshot.h"
+#include "ProcessTable.h"
+#include "ProcEventListener.h"
+#include "PidfdWatcher.h"
+#include "ThreadSampler.h"
 #include <vector>
 #include <string>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <atomic>
 
-struct ProcessInfo {
-    int pid;
-    std::string name;
-    double cpu_usage;
-    long memory_usage;
-    int group_id;
-};
+// Which tasks of a process a priority/affinity policy is applied to.
+enum class ThreadScope { PROCESS, HOT_THREADS, ALL_THREADS };
 
 class ProcessManager {
 public:
-    void adjustPriorities(const SchedulerConfig& config);
-    void pauseProcess(int pid);
-    void resumeProcess(int pid);
-    void terminateProcess(int pid);
+    ProcessManager();
+    ProcessSnapshot captureSnapshot();
+    void adjustPriorities(const SchedulerConfig& config, const ProcessSnapshot& snapshot);
+    void pauseProcess(int pid, unsigned long long start_time);
+    void resumeProcess(int pid, unsigned long long start_time);
+    void terminateProcess(int pid, unsigned long long start_time);
     void setCPUAffinity(int pid, const std::vector<int>& cores);
     void assignToCgroup(int pid, const SchedulerConfig& config);
     std::vector<ProcessInfo> getRunningProcesses();
     void createProcessGroup(int group_id);
+    void setPriority(int pid, int priority);
+    // Places a freshly exec'd process into the mode's cores and cgroup.
+    void placeProcess(int pid, const SchedulerConfig& config);
+
+    // With the proc connector running, scans between reconciliations only
+    // refresh counters; fork/exit events keep the table membership current.
+    bool enableEventSource(std::function<void(int pid)> onExec);
+    void disableEventSource();
+    bool eventSourceActive() const { return eventListener.isRunning(); }
+    void setReconcileInterval(int interval_ms) { reconcileIntervalMs = interval_ms; }
+    void setScanThreadPool(ThreadPool* pool);
+    void configureScanner(const SchedulerConfig& config);
+    // Thread-safe on its own; rules intern their names here once.
+    IdentityCache& identities() { return processTable.identities(); }
 
 private:
-    void setPriority(int pid, int priority);
-    double calculateCPUUsage(int pid);
-    long getProcessMemory(int pid);
+    struct BoostedTask {
+        int pid;
+        int tid;
+        unsigned long long starttime; // Of the thread
+    };
+
+    void handleProcEvent(const ProcEvent& event);
+    void handleExit(int pid, unsigned long long starttime);
+    const std::vector<ThreadSample>& policyTargets(int pid, unsigned long long start_time, ThreadScope scope,
+                                                   double hot_threshold);
+    static ThreadScope parseThreadScope(const std::string& scope);
+
+    ProcessTable processTable;
+    std::mutex tableMtx;
+    std::vector<BoostedTask> boostedTasks; // priority_high applied last cycle
+    std::vector<BoostedTask> nextBoostedTasks;
+    std::vector<ThreadSample> threadTargets;
+    ThreadSampler threadSampler;
+    std::mutex policyMtx;
+    std::chrono::steady_clock::time_point lastFullScan;
+    std::atomic<int> reconcileIntervalMs{5000};
+    std::function<void(int pid)> execHandler;
+    PidfdWatcher exitWatcher;
+    ProcEventListener eventListener; // Declared last so it stops before the table goes away
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "ProcessSnapshot.h"
+#include <algorithm>
+
+const size_t ProcessSnapshot::npos;
+
+ProcessSnapshot::ProcessSnapshot() : captured_at(std::chrono::steady_clock::now()) {}
+
+void ProcessSnapshot::Builder::reserve(size_t n) {
+    pids.reserve(n);
+    start_times.reserve(n);
+    identities.reserve(n);
+    cpu_usage.reserve(n);
+    memory_usage.reserve(n);
+    cpu_delay.reserve(n);
+    io_delay.reserve(n);
+    wait_rate.reserve(n);
+    sched_latency.reserve(n);
+    has_schedstat.reserve(n);
+    flags.reserve(n);
+    classes.reserve(n);
+}
+
+void ProcessSnapshot::Builder::add(const ProcessInfo& info) {
+    pids.push_back(info.pid);
+    start_times.push_back(info.start_time);
+    identities.push_back(info.identity);
+    cpu_usage.push_back(info.cpu_usage);
+    memory_usage.push_back(info.memory_usage);
+    cpu_delay.push_back(info.cpu_delay);
+    io_delay.push_back(info.io_delay);
+    wait_rate.push_back(info.wait_rate);
+    sched_latency.push_back(info.sched_latency_us);
+    has_schedstat.push_back(info.has_schedstat);
+    flags.push_back(info.flags);
+    classes.push_back(info.process_class);
+}
+
+ProcessSnapshot ProcessSnapshot::Builder::build(std::chrono::steady_clock::time_point captured_at) {
+    ProcessSnapshot snapshot;
+    snapshot.pid_column = std::move(pids);
+    snapshot.start_time_column = std::move(start_times);
+    snapshot.identity_column = std::move(identities);
+    snapshot.cpu_column = std::move(cpu_usage);
+    snapshot.memory_column = std::move(memory_usage);
+    snapshot.cpu_delay_column = std::move(cpu_delay);
+    snapshot.io_delay_column = std::move(io_delay);
+    snapshot.wait_rate_column = std::move(wait_rate);
+    snapshot.sched_latency_column = std::move(sched_latency);
+    snapshot.flags_column = std::move(flags);
+    snapshot.class_column = std::move(classes);
+    snapshot.actionable_rows = DecisionBitmap(snapshot.class_column.size());
+    snapshot.schedstat_rows = DecisionBitmap(snapshot.class_column.size());
+    for (size_t i = 0; i < snapshot.class_column.size(); ++i) {
+        if (ProcessClassifier::isActionable(snapshot.class_column[i])) snapshot.actionable_rows.set(i);
+        if (has_schedstat[i]) snapshot.schedstat_rows.set(i);
+    }
+    has_schedstat.clear();
+    snapshot.pid_order.resize(snapshot.pid_column.size());
+    for (size_t i = 0; i < snapshot.pid_order.size(); ++i) snapshot.pid_order[i] = i;
+    const std::vector<int>& pid_column = snapshot.pid_column;
+    std::sort(snapshot.pid_order.begin(), snapshot.pid_order.end(),
+              [&](size_t a, size_t b) { return pid_column[a] < pid_column[b]; });
+    snapshot.captured_at = captured_at;
+    return snapshot;
+}
+
+ProcessInfo ProcessSnapshot::at(size_t i) const {
+    ProcessInfo info;
+    info.pid = pid_column[i];
+    info.start_time = start_time_column[i];
+    info.name = name(i);
+    info.identity = identity_column[i];
+    info.cpu_usage = cpu_column[i];
+    info.memory_usage = memory_column[i];
+    info.cpu_delay = cpu_delay_column[i];
+    info.io_delay = io_delay_column[i];
+    info.wait_rate = wait_rate_column[i];
+    info.sched_latency_us = sched_latency_column[i];
+    info.has_schedstat = schedstat_rows.test(i);
+    info.flags = flags_column[i];
+    info.process_class = class_column[i];
+    info.group_id = 0;
+    return info;
+}
+
+const std::string& ProcessSnapshot::name(size_t i) const {
+    static const std::string unknown;
+    return identity_column[i] ? *identity_column[i]->comm : unknown;
+}
+
+// Policies look rows up per process, so a linear search here would make a
+// cycle quadratic; pid_order is sorted once when the snapshot is built.
+size_t ProcessSnapshot::indexOf(int pid) const {
+    auto it = std::lower_bound(pid_order.begin(), pid_order.end(), pid,
+                               [this](size_t row, int value) { return pid_column[row] < value; });
+    return (it == pid_order.end() || pid_column[*it] != pid) ? npos : *it;
+}
+
+bool ProcessSnapshot::find(int pid, ProcessInfo& out) const {
+    size_t i = indexOf(pid);
+    if (i == npos) return false;
+    out = at(i);
+    return true;
+}
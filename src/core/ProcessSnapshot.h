@@ -0,0 +1,107 @@
+#ifndef PROCESS_SNAPSHOT_H
+#define PROCESS_SNAPSHOT_H
+
+#include "ProcessClassifier.h"
+#include "IdentityCache.h"
+#include "PolicyClassifier.h"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+struct ProcessInfo {
+    int pid;
+    unsigned long long start_time; // With pid, a stable identity across scans
+    std::string name;              // comm
+    std::shared_ptr<const ProcessIdentity> identity;
+    double cpu_usage;
+    long memory_usage;
+    double cpu_delay;              // % of the interval waiting for a CPU (TASKSTATS backend)
+    double io_delay;               // % of the interval waiting on block I/O or swap-in
+    double wait_rate;              // ms per second runnable but not running (schedstat)
+    double sched_latency_us;       // Mean run-queue wait per timeslice
+    bool has_schedstat;            // false: the two above are 0 because nothing was measured
+    unsigned int flags;            // PF_* flags from /proc/[pid]/stat
+    ProcessClass process_class;
+    int group_id;
+};
+
+// Immutable view of the process list captured once per scheduling cycle and
+// shared by const reference, so every consumer sees the same /proc state.
+// Stored as parallel columns so policy passes stream over contiguous
+// doubles and longs (see PolicyClassifier); row i of every column
+// describes the same process.
+class ProcessSnapshot {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    class Builder {
+    public:
+        void reserve(size_t n);
+        void add(const ProcessInfo& info);
+        ProcessSnapshot build(std::chrono::steady_clock::time_point captured_at);
+
+    private:
+        std::vector<int> pids;
+        std::vector<unsigned long long> start_times;
+        std::vector<std::shared_ptr<const ProcessIdentity>> identities;
+        std::vector<double> cpu_usage;
+        std::vector<long> memory_usage;
+        std::vector<double> cpu_delay;
+        std::vector<double> io_delay;
+        std::vector<double> wait_rate;
+        std::vector<double> sched_latency;
+        std::vector<unsigned char> has_schedstat;
+        std::vector<unsigned int> flags;
+        std::vector<ProcessClass> classes;
+    };
+
+    ProcessSnapshot();
+
+    size_t size() const { return pid_column.size(); }
+    bool empty() const { return pid_column.empty(); }
+    std::chrono::steady_clock::time_point capturedAt() const { return captured_at; }
+
+    const std::vector<int>& pids() const { return pid_column; }
+    const std::vector<unsigned long long>& startTimes() const { return start_time_column; }
+    // Shared with the identity cache; compare interned strings by pointer.
+    const std::vector<std::shared_ptr<const ProcessIdentity>>& identities() const { return identity_column; }
+    const std::string& name(size_t i) const;
+    const std::vector<double>& cpuUsage() const { return cpu_column; }
+    const std::vector<long>& memoryUsage() const { return memory_column; }
+    const std::vector<double>& cpuDelay() const { return cpu_delay_column; }
+    const std::vector<double>& ioDelay() const { return io_delay_column; }
+    // Run-queue wait in ms per second, any backend; the signal to target
+    // for "is the foreground actually getting to run".
+    const std::vector<double>& waitRate() const { return wait_rate_column; }
+    const std::vector<double>& schedLatency() const { return sched_latency_column; } // us per timeslice
+    // Rows whose waitRate() and schedLatency() were actually measured.
+    const DecisionBitmap& hasSchedstat() const { return schedstat_rows; }
+    const std::vector<unsigned int>& flags() const { return flags_column; }
+    const std::vector<ProcessClass>& classes() const { return class_column; }
+    // Rows the scheduling policies may act on (see ProcessClassifier).
+    const DecisionBitmap& actionable() const { return actionable_rows; }
+
+    ProcessInfo at(size_t i) const;
+    size_t indexOf(int pid) const; // npos if absent; O(log n)
+    bool find(int pid, ProcessInfo& out) const;
+
+private:
+    std::vector<int> pid_column;
+    std::vector<unsigned long long> start_time_column;
+    std::vector<std::shared_ptr<const ProcessIdentity>> identity_column;
+    std::vector<double> cpu_column;
+    std::vector<long> memory_column;
+    std::vector<double> cpu_delay_column;
+    std::vector<double> io_delay_column;
+    std::vector<double> wait_rate_column;
+    std::vector<double> sched_latency_column;
+    std::vector<unsigned int> flags_column;
+    std::vector<ProcessClass> class_column;
+    DecisionBitmap actionable_rows;
+    DecisionBitmap schedstat_rows;
+    std::vector<size_t> pid_order; // Row numbers sorted by pid, for indexOf()
+    std::chrono::steady_clock::time_point captured_at;
+};
+
+#endif
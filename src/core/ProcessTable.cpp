@@ -0,0 +1,342 @@
+#include "ProcessTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcessTable::ProcessTable()
+    : exitWatcher(nullptr), generation(0), appeared(0), exited(0), sampled(0), ticks_per_second(sysconf(_SC_CLK_TCK)), forceFull(true),
+      sampledJiffies(0), skippedCpuPercent(0.0), lastSystemBusy(0) {
+    stat_fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+}
+
+ProcessTable::~ProcessTable() {
+    if (stat_fd != -1) close(stat_fd);
+}
+
+// Known processes that are not due are only marked as seen. A watched
+// pidfd reports the exit of the original, so its PID is trusted; the rest
+// have their stat file read for the starttime once every warm_interval
+// scans, spread over the scans by PID. A recycled PID is then read in full
+// like a new process, at most warm_interval scans late, or right away when
+// a TASKSTATS exit record for the original came in first.
+void ProcessTable::scan() {
+    ++generation;
+    appeared = 0;
+    exited = 0;
+    drainExits();
+    if (!scanner.listPids(pidBuffer)) return;
+    size_t kept = 0;
+    size_t verified = 0;
+    unsigned int verify_interval = std::max(1u, sampling.warm_interval);
+    ProcStat stat;
+    for (int pid : pidBuffer) {
+        auto it = index.find(pid);
+        if (it != index.end() && !due(slots[it->second])) {
+            ProcessEntry& entry = slots[it->second];
+            bool same = true;
+            if (!(exitWatcher && exitWatcher->isWatched(pid)) && (pid + generation) % verify_interval == 0) {
+                ++verified;
+                same = ProcStatParser::readAt(scanner.procFd(), pid, stat) && stat.starttime == entry.key.starttime;
+            }
+            if (same) {
+                entry.generation = generation;
+                skippedCpuPercent += entry.cpu_usage;
+                continue;
+            }
+        }
+        pidBuffer[kept++] = pid;
+    }
+    pidBuffer.resize(kept);
+    sampleDue(std::chrono::steady_clock::now(), false);
+    sampled += verified;
+
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        if (slots[slot].live && slots[slot].generation != generation) release(slot);
+    }
+    checkUnaccountedCPU();
+}
+
+void ProcessTable::refresh() {
+    ++generation;
+    appeared = 0;
+    exited = 0;
+    drainExits();
+    pidBuffer.clear();
+    slotBuffer.clear();
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        if (!slots[slot].live) continue;
+        if (!due(slots[slot])) {
+            skippedCpuPercent += slots[slot].cpu_usage;
+            continue;
+        }
+        pidBuffer.push_back(slots[slot].key.pid);
+        slotBuffer.push_back(slot);
+    }
+    sampleDue(std::chrono::steady_clock::now(), true);
+    for (size_t i = 0; i < sampleBuffer.size(); ++i) {
+        if (!sampleBuffer[i].valid && slots[slotBuffer[i]].live && slots[slotBuffer[i]].key.pid == pidBuffer[i]) {
+            release(slotBuffer[i]); // Exit event was missed
+        }
+    }
+    checkUnaccountedCPU();
+}
+
+// Drops processes whose TASKSTATS exit records arrived since the last
+// cycle. Both scan() and refresh() drain them, so the socket never fills.
+void ProcessTable::drainExits() {
+    exitBuffer.clear();
+    scanner.drainExits(exitBuffer);
+    for (int pid : exitBuffer) remove(pid);
+}
+
+// Reads the PIDs in pidBuffer into sampleBuffer, row for row, and merges
+// the valid samples; counters_only lets the scanner take the cheaper path.
+void ProcessTable::sampleDue(std::chrono::steady_clock::time_point now, bool counters_only) {
+    sampleBuffer.resize(pidBuffer.size());
+    if (counters_only) {
+        scanner.sampleCounters(pidBuffer.data(), pidBuffer.size(), sampleBuffer.data());
+    } else {
+        scanner.sample(pidBuffer.data(), pidBuffer.size(), sampleBuffer.data());
+    }
+    sampled = pidBuffer.size();
+    for (const auto& sample : sampleBuffer) {
+        if (sample.valid) merge(sample, now);
+    }
+}
+
+// Skipped processes can wake up between their samples. Compare the system's
+// busy time with what the sampled processes account for plus the skipped
+// ones at their last known CPU%; if more than half a CPU went somewhere
+// unseen, read everything next cycle.
+void ProcessTable::checkUnaccountedCPU() {
+    bool tiered = sampling.warm_interval > 1 || sampling.idle_interval > 1;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastCheck).count();
+    double skipped = skippedCpuPercent;
+    unsigned long long seen = sampledJiffies;
+    sampledJiffies = 0;
+    skippedCpuPercent = 0.0;
+    lastCheck = now;
+    forceFull = false;
+    if (!tiered || stat_fd == -1) return;
+
+    char buf[256];
+    ssize_t n = pread(stat_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return;
+    buf[n] = '\0';
+    unsigned long long user = 0, nice = 0, system = 0;
+    if (sscanf(buf, "cpu %llu %llu %llu", &user, &nice, &system) != 3) return;
+    unsigned long long busy = user + nice + system;
+    if (lastSystemBusy != 0 && busy >= lastSystemBusy) {
+        double accounted = seen + skipped / 100.0 * ticks_per_second * elapsed;
+        double slack = 0.5 * ticks_per_second * elapsed;
+        forceFull = static_cast<double>(busy - lastSystemBusy) > accounted + slack;
+    }
+    lastSystemBusy = busy;
+}
+
+void ProcessTable::updateTier(ProcessEntry& entry, unsigned long long delta) {
+    if (entry.cpu_usage > sampling.hot_threshold) {
+        entry.tier = SamplingTier::HOT;
+        entry.quiet_samples = 0;
+    } else if (entry.tier == SamplingTier::IDLE) {
+        if (delta > 0) entry.tier = SamplingTier::WARM; // Counters moved again
+    } else if (++entry.quiet_samples >= 3) {
+        bool stopped = delta == 0;
+        if (entry.tier == SamplingTier::HOT) {
+            entry.tier = SamplingTier::WARM;
+            entry.quiet_samples = 0;
+        } else if (stopped) {
+            entry.tier = SamplingTier::IDLE;
+            entry.quiet_samples = 0;
+        }
+    }
+    unsigned int interval = 1;
+    if (entry.tier == SamplingTier::WARM) interval = sampling.warm_interval;
+    if (entry.tier == SamplingTier::IDLE) interval = sampling.idle_interval;
+    entry.next_sample = generation + (interval ? interval : 1);
+}
+
+void ProcessTable::track(int pid) {
+    ProcSample sample;
+    if (!scanner.sampleOne(pid, sample)) return;
+    auto it = index.find(pid);
+    if (it != index.end() && slots[it->second].key.starttime == sample.stat.starttime) return;
+    merge(sample, std::chrono::steady_clock::now());
+}
+
+void ProcessTable::reclassify(int pid) {
+    ProcSample sample;
+    if (!scanner.sampleOne(pid, sample)) return;
+    auto it = index.find(pid);
+    if (it == index.end() || slots[it->second].key.starttime != sample.stat.starttime) {
+        merge(sample, std::chrono::steady_clock::now());
+        return;
+    }
+    ProcessEntry& entry = slots[it->second];
+    entry.identity = identityCache.load(scanner.procFd(), entry.key, sample.stat.comm);
+    entry.process_class = classifier.classify(scanner.procFd(), sample.stat, *entry.identity->cgroup);
+    updateWatch(entry);
+}
+
+void ProcessTable::setExclusions(const std::vector<std::string>& names) {
+    classifier.setExclusions(names);
+    ProcSample sample;
+    for (auto& entry : slots) {
+        if (!entry.live || !scanner.sampleOne(entry.key.pid, sample)) continue;
+        if (sample.stat.starttime == entry.key.starttime) {
+            entry.process_class = classifier.classify(scanner.procFd(), sample.stat, *entry.identity->cgroup);
+            updateWatch(entry);
+        }
+    }
+}
+
+void ProcessTable::remove(int pid) {
+    auto it = index.find(pid);
+    if (it != index.end()) release(it->second);
+}
+
+void ProcessTable::remove(const ProcessKey& key) {
+    auto it = index.find(key.pid);
+    if (it != index.end() && slots[it->second].key.starttime == key.starttime) release(it->second);
+}
+
+void ProcessTable::updateWatch(const ProcessEntry& entry) {
+    if (!exitWatcher) return;
+    if (ProcessClassifier::isActionable(entry.process_class)) {
+        exitWatcher->watch(entry.key.pid, entry.key.starttime);
+    } else {
+        exitWatcher->unwatch(entry.key.pid);
+    }
+}
+
+ProcessEntry* ProcessTable::find(int pid) {
+    auto it = index.find(pid);
+    return (it == index.end()) ? nullptr : &slots[it->second];
+}
+
+ProcessEntry* ProcessTable::find(const ProcessKey& key) {
+    ProcessEntry* entry = find(key.pid);
+    return (entry && entry->key.starttime == key.starttime) ? entry : nullptr;
+}
+
+// counters_only samples carry no starttime; they are only taken for known
+// processes between reconciliation scans, which re-check identity. Zombies
+// are left out until their PID leaves /proc.
+void ProcessTable::merge(const ProcSample& sample, std::chrono::steady_clock::time_point now) {
+    auto it = index.find(sample.stat.pid);
+    if (sample.counters_only) {
+        if (it != index.end()) refresh(slots[it->second], sample, now);
+    } else if (sample.stat.state == 'Z' || sample.stat.state == 'X') {
+        // Exited but not reaped yet. Tracking it again would watch a pidfd
+        // that is already readable and drop it again, every cycle.
+        if (it != index.end()) release(it->second);
+    } else if (it == index.end()) {
+        track(sample, now);
+    } else if (slots[it->second].key.starttime != sample.stat.starttime) {
+        release(it->second); // PID was reused by a different process
+        track(sample, now);
+    } else {
+        refresh(slots[it->second], sample, now);
+    }
+}
+
+void ProcessTable::track(const ProcSample& sample, std::chrono::steady_clock::time_point now) {
+    const ProcStat& stat = sample.stat;
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = slots.size();
+        slots.emplace_back();
+    }
+    ProcessEntry& entry = slots[slot];
+    entry.key = ProcessKey{stat.pid, stat.starttime};
+    entry.identity = identityCache.load(scanner.procFd(), entry.key, stat.comm);
+    entry.jiffies = stat.utime + stat.stime;
+    entry.sampled_at = now;
+    entry.cpu_usage = 0.0; // No interval yet
+    entry.memory_usage = sample.memory_usage;
+    entry.read_bytes = sample.read_bytes;
+    entry.write_bytes = sample.write_bytes;
+    entry.cpu_delay_ns = sample.has_delays ? sample.cpu_delay_ns : 0;
+    entry.io_delay_ns = sample.has_delays ? sample.io_delay_ns : 0;
+    entry.cpu_delay = 0.0;
+    entry.io_delay = 0.0;
+    entry.run_ns = sample.run_ns;
+    entry.wait_ns = sample.wait_ns;
+    entry.timeslices = sample.timeslices;
+    entry.wait_rate = 0.0;
+    entry.sched_latency_us = 0.0;
+    entry.has_schedstat = sample.has_schedstat;
+    entry.counters_only = false;
+    entry.generation = generation;
+    entry.flags = stat.flags;
+    entry.process_class = classifier.classify(scanner.procFd(), stat, *entry.identity->cgroup);
+    entry.tier = SamplingTier::HOT; // New processes are usually busy starting up
+    entry.quiet_samples = 0;
+    entry.next_sample = generation + 1;
+    entry.live = true;
+    index[stat.pid] = slot;
+    updateWatch(entry);
+    ++appeared;
+}
+
+void ProcessTable::refresh(ProcessEntry& entry, const ProcSample& sample, std::chrono::steady_clock::time_point now) {
+    const ProcStat& stat = sample.stat;
+    unsigned long long jiffies = stat.utime + stat.stime;
+    double elapsed = std::chrono::duration<double>(now - entry.sampled_at).count();
+    if (sample.counters_only != entry.counters_only) {
+        // /proc and TASKSTATS round CPU time differently, and /proc's
+        // schedstat covers only the main thread; start a new baseline.
+        entry.counters_only = sample.counters_only;
+    } else {
+        unsigned long long delta = (jiffies >= entry.jiffies) ? jiffies - entry.jiffies : 0;
+        entry.cpu_usage = (elapsed > 0.0) ? 100.0 * delta / (ticks_per_second * elapsed) : 0.0;
+        sampledJiffies += delta;
+        updateTier(entry, delta);
+        if (sample.has_schedstat && entry.has_schedstat && elapsed > 0.0) {
+            unsigned long long waited = sample.wait_ns - std::min(sample.wait_ns, entry.wait_ns);
+            unsigned long long slices = sample.timeslices - std::min(sample.timeslices, entry.timeslices);
+            entry.wait_rate = waited / 1e6 / elapsed;
+            entry.sched_latency_us = slices ? waited / 1e3 / slices : 0.0;
+        }
+    }
+    if (sample.has_schedstat) {
+        entry.run_ns = sample.run_ns;
+        entry.wait_ns = sample.wait_ns;
+        entry.timeslices = sample.timeslices;
+    }
+    entry.has_schedstat = sample.has_schedstat;
+    if (sample.has_delays) {
+        double elapsed_ns = elapsed * 1e9;
+        if (elapsed_ns > 0.0 && entry.cpu_delay_ns != 0) {
+            entry.cpu_delay = 100.0 * (sample.cpu_delay_ns - std::min(sample.cpu_delay_ns, entry.cpu_delay_ns)) / elapsed_ns;
+            entry.io_delay = 100.0 * (sample.io_delay_ns - std::min(sample.io_delay_ns, entry.io_delay_ns)) / elapsed_ns;
+        }
+        entry.cpu_delay_ns = sample.cpu_delay_ns;
+        entry.io_delay_ns = sample.io_delay_ns;
+    }
+    entry.jiffies = jiffies;
+    entry.sampled_at = now;
+    entry.memory_usage = sample.memory_usage;
+    entry.read_bytes = sample.read_bytes;
+    entry.write_bytes = sample.write_bytes;
+    entry.generation = generation;
+    if (!sample.counters_only) {
+        entry.process_class = ProcessClassifier::jobControlClass(entry.process_class, stat, *entry.identity->cgroup);
+    }
+}
+
+void ProcessTable::release(size_t slot) {
+    ProcessEntry& entry = slots[slot];
+    index.erase(entry.key.pid);
+    if (exitWatcher) exitWatcher->unwatch(entry.key.pid);
+    identityCache.erase(entry.key);
+    entry.identity.reset();
+    entry.live = false;
+    freeSlots.push_back(slot);
+    ++exited;
+}
@@ -0,0 +1,130 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include "ProcScanner.h"
+#include "ProcessKey.h"
+#include "IdentityCache.h"
+#include "ProcessClassifier.h"
+#include "PidfdWatcher.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+
+// How often a process's counters are re-read. Busy processes are read every
+// cycle, quiet ones every warm_interval cycles, processes whose counters have
+// stopped moving every idle_interval cycles.
+enum class SamplingTier : unsigned char { HOT, WARM, IDLE };
+
+struct SamplingPolicy {
+    unsigned int warm_interval = 1;  // 1 disables tiering
+    unsigned int idle_interval = 1;
+    double hot_threshold = 5.0;      // CPU% that promotes a process to HOT
+};
+
+struct ProcessEntry {
+    ProcessKey key;
+    std::shared_ptr<const ProcessIdentity> identity; // Loaded when the slot is created and on exec
+    unsigned long long jiffies;   // utime + stime at the last refresh
+    std::chrono::steady_clock::time_point sampled_at;
+    double cpu_usage;             // CPU% since the previous refresh
+    long memory_usage;            // KB
+    unsigned long long read_bytes;  // Cumulative, only with sample_process_io
+    unsigned long long write_bytes;
+    unsigned long long cpu_delay_ns;  // Cumulative delay accounting, 0 without TASKSTATS
+    unsigned long long io_delay_ns;
+    double cpu_delay;             // % of the interval spent runnable but not running
+    double io_delay;              // % of the interval spent waiting on block I/O or swap-in
+    unsigned long long run_ns;    // Cumulative schedstat counters (see ProcSample)
+    unsigned long long wait_ns;
+    unsigned long long timeslices;
+    double wait_rate;             // ms per second spent runnable but waiting on a run queue
+    double sched_latency_us;      // Mean run-queue wait per timeslice over the interval
+    bool has_schedstat;
+    bool counters_only;           // Counters of the last refresh came from TASKSTATS
+    unsigned long generation;     // Last scan that saw this process
+    unsigned int flags;           // PF_* flags
+    ProcessClass process_class;   // Decided when the slot is created or on exec; tty jobs on each read
+    SamplingTier tier;
+    unsigned int quiet_samples;   // Consecutive samples below the tier's bar
+    unsigned long next_sample;    // Generation at which counters are re-read
+    bool live;                    // false while the slot is on the free list
+};
+
+// Long-lived table of known processes. Slots are reused, so a steady-state
+// scan only refreshes counters and allocates nothing.
+class ProcessTable {
+public:
+    ProcessTable();
+    ~ProcessTable();
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+    // Spreads per-PID reads of large scans across the pool.
+    void setThreadPool(ThreadPool* pool) { scanner.setThreadPool(pool); }
+    void setReaderBackend(ProcReaderBackend backend) { scanner.setBackend(backend); }
+    void setReadIO(bool enabled) { scanner.setReadIO(enabled); }
+    void setSamplingPolicy(const SamplingPolicy& policy) { sampling = policy; }
+    // Actionable processes get a pidfd in the watcher while they are tracked.
+    void setExitWatcher(PidfdWatcher* watcher) { exitWatcher = watcher; }
+    // Replaces the exclusion list and reclassifies every tracked process.
+    void setExclusions(const std::vector<std::string>& names);
+
+    // Lists /proc, refreshes counters of processes that are due, adds new
+    // ones and releases slots of processes that are gone.
+    void scan();
+    // Refreshes counters of due processes without listing /proc; used
+    // between reconciliation scans when an event source keeps membership.
+    void refresh();
+    // Event-driven membership updates.
+    void track(int pid);
+    void remove(int pid);
+    void remove(const ProcessKey& key); // Ignored if the PID already belongs to a newer process
+    // The image changed; classify the process again.
+    void reclassify(int pid);
+    ProcessEntry* find(int pid);
+    ProcessEntry* find(const ProcessKey& key);
+    const std::vector<ProcessEntry>& entries() const { return slots; } // Check ProcessEntry::live
+    size_t size() const { return index.size(); }
+    size_t appearedLastScan() const { return appeared; }
+    size_t exitedLastScan() const { return exited; }
+    size_t sampledLastScan() const { return sampled; } // PIDs whose files were read, identity checks included
+    IdentityCache& identities() { return identityCache; }
+
+private:
+    void merge(const ProcSample& sample, std::chrono::steady_clock::time_point now);
+    void track(const ProcSample& sample, std::chrono::steady_clock::time_point now);
+    void refresh(ProcessEntry& entry, const ProcSample& sample, std::chrono::steady_clock::time_point now);
+    void release(size_t slot);
+    void sampleDue(std::chrono::steady_clock::time_point now, bool counters_only);
+    void drainExits();
+    void updateTier(ProcessEntry& entry, unsigned long long delta);
+    bool due(const ProcessEntry& entry) const { return forceFull || entry.next_sample <= generation; }
+    void checkUnaccountedCPU();
+    void updateWatch(const ProcessEntry& entry);
+
+    ProcScanner scanner;
+    ProcessClassifier classifier;
+    IdentityCache identityCache;
+    PidfdWatcher* exitWatcher;
+    std::vector<int> pidBuffer;          // Reused between scans
+    std::vector<size_t> slotBuffer;
+    std::vector<ProcSample> sampleBuffer;
+    std::vector<int> exitBuffer;
+    std::vector<ProcessEntry> slots;
+    std::vector<size_t> freeSlots;
+    std::unordered_map<int, size_t> index; // pid -> slot
+    unsigned long generation;
+    size_t appeared;
+    size_t exited;
+    size_t sampled;
+    long ticks_per_second;
+    SamplingPolicy sampling;
+    bool forceFull;                          // Read every process this cycle
+    unsigned long long sampledJiffies;       // Process CPU time seen this cycle
+    double skippedCpuPercent;                // Last CPU% of processes not read
+    unsigned long long lastSystemBusy;
+    std::chrono::steady_clock::time_point lastCheck;
+    int stat_fd;                             // /proc/stat, for the wakeup check
+};
+
+#endif
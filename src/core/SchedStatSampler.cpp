@@ -0,0 +1,114 @@
+#include "SchedStatSampler.h"
+#include "Logger.h"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+unsigned long long parseNumber(const char*& p, const char* end) {
+    while (p < end && *p == ' ') ++p;
+    unsigned long long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) value = value * 10 + (*p - '0');
+    return value;
+}
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+SchedStatSampler::SchedStatSampler() : buffer(16384), hasPrevious(false), lastSampleTime(0.0) {
+    schedstat_fd = open("/proc/schedstat", O_RDONLY | O_CLOEXEC);
+    if (schedstat_fd == -1) Logger::log("/proc/schedstat unavailable; no run-queue statistics");
+}
+
+SchedStatSampler::~SchedStatSampler() {
+    if (schedstat_fd != -1) close(schedstat_fd);
+}
+
+bool SchedStatSampler::sample(SchedStatSnapshot& out) {
+    if (schedstat_fd == -1) return false;
+    size_t len = 0;
+    while (true) {
+        ssize_t n = pread(schedstat_fd, buffer.data() + len, buffer.size() - len, static_cast<off_t>(len));
+        if (n < 0) return false;
+        if (n == 0) break;
+        len += static_cast<size_t>(n);
+        if (len == buffer.size()) buffer.resize(buffer.size() * 2);
+    }
+    double now = nowSeconds();
+    double interval = hasPrevious ? now - lastSampleTime : 0.0;
+    lastSampleTime = now;
+    return update(buffer.data(), len, interval, out);
+}
+
+// cpu lines are "cpuN yld_count 0 sched_count sched_goidle ttwu_count
+// ttwu_local run_ns wait_ns timeslices".
+bool SchedStatSampler::update(const char* buf, size_t len, double interval_seconds, SchedStatSnapshot& out) {
+    const char* end = buf + len;
+    current.assign(current.size(), RunQueueCounters());
+    seen.assign(current.size(), 0);
+    bool any = false;
+    for (const char* line = buf; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        if (eol - line > 3 && memcmp(line, "cpu", 3) == 0 && line[3] >= '0' && line[3] <= '9') {
+            const char* p = line + 3;
+            size_t cpu = static_cast<size_t>(parseNumber(p, eol));
+            if (cpu >= current.size()) {
+                current.resize(cpu + 1, RunQueueCounters());
+                seen.resize(cpu + 1, 0);
+            }
+            for (int skipped = 0; skipped < 6; ++skipped) parseNumber(p, eol);
+            current[cpu].run_ns = parseNumber(p, eol);
+            current[cpu].wait_ns = parseNumber(p, eol);
+            current[cpu].timeslices = parseNumber(p, eol);
+            seen[cpu] = 1;
+            any = true;
+        }
+        line = eol + 1;
+    }
+    if (!any) return false;
+
+    out.since_boot = !hasPrevious;
+    out.interval_seconds = interval_seconds;
+    if (previous.size() < current.size()) previous.resize(current.size(), RunQueueCounters());
+    out.cores.resize(current.size());
+    out.max_wait_rate = 0.0;
+    double interval = hasPrevious ? interval_seconds : 0.0;
+    RunQueueCounters total_now = RunQueueCounters();
+    RunQueueCounters total_before = RunQueueCounters();
+    for (size_t cpu = 0; cpu < current.size(); ++cpu) {
+        if (!seen[cpu]) current[cpu] = previous[cpu]; // Offline: keep the baseline for when it returns
+        out.cores[cpu] = load(current[cpu], previous[cpu], interval);
+        out.cores[cpu].online = seen[cpu] != 0;
+        out.max_wait_rate = std::max(out.max_wait_rate, out.cores[cpu].wait_rate);
+        // Sum clamped per-CPU counters so one CPU's reset cannot go negative.
+        total_now.wait_ns += std::max(current[cpu].wait_ns, previous[cpu].wait_ns);
+        total_now.timeslices += std::max(current[cpu].timeslices, previous[cpu].timeslices);
+        total_before.wait_ns += previous[cpu].wait_ns;
+        total_before.timeslices += previous[cpu].timeslices;
+    }
+    out.total = load(total_now, total_before, interval);
+
+    previous.swap(current);
+    hasPrevious = true;
+    return true;
+}
+
+// A CPU that went offline and came back restarts its counters; clamp each
+// delta so the interval never shows negative time.
+RunQueueLoad SchedStatSampler::load(const RunQueueCounters& now, const RunQueueCounters& before, double interval_seconds) {
+    RunQueueLoad out = RunQueueLoad();
+    out.online = true;
+    if (interval_seconds <= 0.0) return out;
+    unsigned long long wait = now.wait_ns - std::min(now.wait_ns, before.wait_ns);
+    unsigned long long slices = now.timeslices - std::min(now.timeslices, before.timeslices);
+    out.wait_rate = wait / 1e6 / interval_seconds;
+    out.latency_us = slices ? wait / 1e3 / slices : 0.0;
+    return out;
+}
@@ -0,0 +1,58 @@
+#ifndef SCHED_STAT_SAMPLER_H
+#define SCHED_STAT_SAMPLER_H
+
+#include <vector>
+#include <cstddef>
+
+// Cumulative counters of one "cpuN" line of /proc/schedstat (versions 15+).
+struct RunQueueCounters {
+    unsigned long long run_ns;      // Time tasks ran on this CPU
+    unsigned long long wait_ns;     // Time tasks sat runnable on its run queue
+    unsigned long long timeslices;
+};
+
+// Run-queue pressure of one CPU over an interval.
+struct RunQueueLoad {
+    double wait_rate;   // ms of task waiting per second; 1000 = one task always waiting
+    double latency_us;  // Mean wait before each timeslice
+    bool online;        // false for CPUs missing from this sample
+};
+
+struct SchedStatSnapshot {
+    RunQueueLoad total;              // wait_rate summed over CPUs
+    std::vector<RunQueueLoad> cores; // Indexed by CPU number
+    double max_wait_rate;            // Worst single CPU
+    double interval_seconds;
+    bool since_boot;                 // First sample: only a baseline, rates are 0
+};
+
+// Keeps /proc/schedstat open and preads it whole each sample, parsing only
+// the cpu lines (domain lines are skipped). Rates are deltas against the
+// previous sample. Needs CONFIG_SCHEDSTATS; without it the file is missing
+// and sample() fails.
+class SchedStatSampler {
+public:
+    SchedStatSampler();
+    ~SchedStatSampler();
+    SchedStatSampler(const SchedStatSampler&) = delete;
+    SchedStatSampler& operator=(const SchedStatSampler&) = delete;
+
+    bool isSupported() const { return schedstat_fd != -1; }
+    bool sample(SchedStatSnapshot& out);
+    // Parses a /proc/schedstat image and computes rates against the
+    // previous one; sample() is read + update.
+    bool update(const char* buf, size_t len, double interval_seconds, SchedStatSnapshot& out);
+
+private:
+    static RunQueueLoad load(const RunQueueCounters& now, const RunQueueCounters& before, double interval_seconds);
+
+    int schedstat_fd;
+    std::vector<char> buffer;     // Grows to fit; domain lines make it large on big hosts
+    std::vector<RunQueueCounters> previous;
+    std::vector<RunQueueCounters> current;
+    std::vector<unsigned char> seen;
+    bool hasPrevious;
+    double lastSampleTime;
+};
+
+#endif
@@ -2,9 +2,13 @@
 #include "Logger.h"
 #include "SystemMonitor.h"
 #include <chrono>
+#include <algorithm>
 #include <numeric>
 
-Scheduler::Scheduler() : running(false), threadPool(4) {
+Scheduler::Scheduler() : running(false), threadPool(4), pressureDirty(true), lastStallUs(0), lastStallTime(0.0), loadUpdates(0) {
+    modeManager.setScanThreadPool(&threadPool);
+    modeManager.setSystemSampler(&sampler);
+    loadMonitor.attach(&sampler);
     Logger::log("Scheduler initialized with 4 worker threads and IPC");
 }
 
@@ -15,6 +19,9 @@ Scheduler::~Scheduler() {
 void Scheduler::setMode(const std::string& mode) {
     std::lock_guard<std::mutex> lock(mtx);
     modeManager.setMode(mode);
+    sampler.setRate(modeManager.getConfig().sampler_rate_hz);
+    pressureDirty = true;
+    pressure.wake();
     ipcManager.sendMessage("Mode changed to: " + mode);
     Logger::log("Mode set to: " + mode);
 }
@@ -23,6 +30,8 @@ void Scheduler::startScheduling() {
     std::lock_guard<std::mutex> lock(mtx);
     if (running) return;
     running = true;
+    modeManager.enableCpuFreq();
+    sampler.start(modeManager.getConfig().sampler_rate_hz);
     workerThreads.emplace_back(&Scheduler::scheduleWorker, this);
     Logger::log("Scheduling started");
 }
@@ -30,23 +39,60 @@ void Scheduler::startScheduling() {
 void Scheduler::stopScheduling() {
     std::lock_guard<std::mutex> lock(mtx);
     running = false;
+    pressure.wake();
     threadPool.stop();
     for (auto& thread : workerThreads) {
         if (thread.joinable()) thread.join();
     }
     workerThreads.clear();
+    sampler.stop();
+    modeManager.disableCpuFreq();
     Logger::log("Scheduling stopped");
 }
 
+// With PSI triggers armed the worker sleeps up to calm_interval_ms and is
+// woken early by the kernel when a stall crosses the mode's threshold;
+// without PSI it falls back to sleeping time_quantum_ms.
 void Scheduler::scheduleWorker() {
-    SystemMonitor monitor;
     while (running) {
+        if (pressureDirty.exchange(false)) armPressureTriggers(modeManager.getConfig());
         adjustQuantumBasedOnLoad();
         scheduleProcesses();
-        std::this_thread::sleep_for(std::chrono::milliseconds(modeManager.getConfig().time_quantum_ms));
+        SchedulerConfig config = modeManager.getConfig();
+        if (!pressure.hasTriggers()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.time_quantum_ms));
+            continue;
+        }
+        unsigned int stalls = pressure.wait(std::max(config.time_quantum_ms, config.calm_interval_ms));
+        if (stalls & (PressureMonitor::CPU_STALL | PressureMonitor::MEMORY_STALL | PressureMonitor::IO_STALL)) {
+            PressureSnapshot snapshot;
+            pressure.read(snapshot);
+            std::string stalled;
+            if (stalls & PressureMonitor::CPU_STALL) stalled += " cpu";
+            if (stalls & PressureMonitor::MEMORY_STALL) stalled += " memory";
+            if (stalls & PressureMonitor::IO_STALL) stalled += " io";
+            Logger::log("PSI stall on" + stalled + " (some avg10: cpu " + std::to_string(snapshot.cpu.some.avg10) +
+                        "%, memory " + std::to_string(snapshot.memory.some.avg10) + "%, io " +
+                        std::to_string(snapshot.io.some.avg10) + "%), scheduling now");
+        }
     }
 }
 
+void Scheduler::armPressureTriggers(const SchedulerConfig& config) {
+    pressure.clearTriggers();
+    if (!pressure.isSupported()) return;
+    unsigned int window_us = static_cast<unsigned int>(config.psi_window_ms) * 1000;
+    const std::pair<PressureResource, int> thresholds[] = {{PressureResource::CPU, config.psi_cpu_stall_ms},
+                                                           {PressureResource::MEMORY, config.psi_memory_stall_ms},
+                                                           {PressureResource::IO, config.psi_io_stall_ms}};
+    for (const auto& threshold : thresholds) {
+        if (threshold.second <= 0) continue;
+        pressure.addTrigger(threshold.first, false, static_cast<unsigned int>(threshold.second) * 1000, window_us);
+    }
+    Logger::log("Armed " + std::string(pressure.hasTriggers() ? "PSI triggers" : "no PSI triggers") + " over a " +
+                std::to_string(config.psi_window_ms) + "ms window");
+}
+
 void Scheduler::scheduleProcesses() {
     threadPool.enqueue([this]() {
         modeManager.applyScheduling();
@@ -54,26 +100,76 @@ void Scheduler::scheduleProcesses() {
     });
 }
 
+// Sizes the quantum for the load expected FORECAST_QUANTA quanta from now.
+// The forecast is trusted in proportion to its recent accuracy, and a
+// confident forecast also moves the quantum in larger steps. While
+// foreground processes are measured, their run-queue wait is the target
+// and utilisation only caps growth; otherwise utilisation decides alone.
 void Scheduler::adjustQuantumBasedOnLoad() {
-    SystemMonitor monitor;
-    double load = monitor.getSystemCPUUsage();
-    auto& config = modeManager.getConfig();
-    if (load > 80.0) {
-        config.time_quantum_ms = std::max(5, config.time_quantum_ms - 5);
-    } else if (load < 20.0) {
-        config.time_quantum_ms = std::min(100, config.time_quantum_ms + 5);
+    double load = loadMonitor.getSystemCPUUsage(); // Smoothed by the sampler
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    cpuForecast.update(load, now);
+    PressureSnapshot psi;
+    if (pressure.read(psi)) {
+        double elapsed = now - lastStallTime;
+        if (lastStallTime > 0.0 && elapsed > 0.0 && psi.cpu.some.total_us >= lastStallUs) {
+            stallForecast.update(100.0 * (psi.cpu.some.total_us - lastStallUs) / (elapsed * 1e6), now);
+        }
+        lastStallUs = psi.cpu.some.total_us;
+        lastStallTime = now;
+    }
+
+    SchedulerConfig config = modeManager.getConfig();
+    double horizon = FORECAST_QUANTA * config.time_quantum_ms / 1000.0;
+    LoadOutlook outlook;
+    outlook.confidence = cpuForecast.confidence();
+    outlook.cpu = outlook.confidence * cpuForecast.forecast(horizon) + (1.0 - outlook.confidence) * load;
+    outlook.cpu_stall = stallForecast.samples() ? stallForecast.forecast(horizon) : 0.0;
+    modeManager.setLoadOutlook(outlook);
+
+    int step = 5 + static_cast<int>(5.0 * outlook.confidence + 0.5);
+    ForegroundWait foreground = modeManager.foregroundWait();
+    bool shrink, grow;
+    if (foreground.processes) {
+        double target = config.foreground_wait_target_ms;
+        shrink = foreground.max_wait_rate > target;
+        grow = foreground.max_wait_rate < target / 2.0 && outlook.cpu < 80.0;
+    } else {
+        shrink = outlook.cpu > 80.0 || outlook.cpu_stall > 10.0;
+        grow = outlook.cpu < 20.0;
+    }
+    if (shrink) {
+        config.time_quantum_ms = std::max(5, config.time_quantum_ms - step);
+    } else if (grow) {
+        config.time_quantum_ms = std::min(100, config.time_quantum_ms + step);
     }
-    Logger::log("Adjusted quantum to " + std::to_string(config.time_quantum_ms) + "ms based on CPU load: " + std::to_string(load));
+    modeManager.setTimeQuantum(config.time_quantum_ms);
+    Logger::log("Adjusted quantum to " + std::to_string(config.time_quantum_ms) + "ms based on CPU load: " +
+                std::to_string(load) + ", expected " + std::to_string(outlook.cpu) + " (confidence " +
+                std::to_string(outlook.confidence) + "), CPU stall " + std::to_string(outlook.cpu_stall) +
+                "%, foreground wait " + std::to_string(foreground.max_wait_rate) + "ms/s over " +
+                std::to_string(foreground.processes) + " processes");
 }
 
 double Scheduler::getCurrentCPULoad() {
-    SystemMonitor monitor;
-    return monitor.getSystemCPUUsage();
+    return loadMonitor.getSystemCPUUsage();
 }
 
+// Past the cap the least recently updated history makes room; the scan only
+// happens when a new PID arrives at a full map.
 void Scheduler::updateProcessLoad(int pid, double load) {
-    processLoadHistory[pid] = load;
-    if (processLoadHistory.size() > 100) {
-        processLoadHistory.erase(processLoadHistory.begin());
+    auto it = processLoadHistory.find(pid);
+    if (it == processLoadHistory.end()) {
+        if (processLoadHistory.size() >= MAX_LOAD_HISTORIES) {
+            auto stalest = std::min_element(processLoadHistory.begin(), processLoadHistory.end(),
+                                            [](const std::pair<const int, ProcessLoadHistory>& a,
+                                               const std::pair<const int, ProcessLoadHistory>& b) {
+                                                return a.second.updated < b.second.updated;
+                                            });
+            processLoadHistory.erase(stalest);
+        }
+        it = processLoadHistory.emplace(pid, ProcessLoadHistory()).first;
     }
+    it->second.loads.push(load);
+    it->second.updated = ++loadUpdates;
 }
\ No newline at end of file
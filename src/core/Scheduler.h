@@ -4,11 +4,23 @@
 #include "ModeManager.h"
 #include "ThreadPool.h"
 #include "IPCManager.h"
+#include "SystemMonitor.h"
+#include "PressureMonitor.h"
+#include "SystemSampler.h"
+#include "LoadForecaster.h"
+#include "RingBuffer.h"
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <atomic>
-#include <map>
+#include <unordered_map>
+
+// Recent loads of one process; updated is the load update that last touched
+// it, so the history that went quiet longest is the one evicted.
+struct ProcessLoadHistory {
+    RingBuffer<double, 16> loads;
+    unsigned long long updated = 0;
+};
 
 class Scheduler {
 public:
@@ -20,17 +32,31 @@ public:
     void scheduleProcesses();
     void adjustQuantumBasedOnLoad();
     double getCurrentCPULoad();
+    const SystemSampler& systemSampler() const { return sampler; }
 
 private:
     std::atomic<bool> running;
     std::mutex mtx;
     std::vector<std::thread> workerThreads;
+    SystemSampler sampler;     // Declared first: the monitors below read from it
     ModeManager modeManager;
     ThreadPool threadPool;
     IPCManager ipcManager;
-    std::map<int, double> processLoadHistory; // For adaptive scheduling
+    SystemMonitor loadMonitor; // Attached to sampler; reads /proc itself only before its first sample
+    PressureMonitor pressure;  // Only touched by the worker thread, except wake()
+    std::atomic<bool> pressureDirty; // Mode changed; re-arm PSI triggers
+    LoadForecaster cpuForecast;      // Worker thread only, like the two below
+    LoadForecaster stallForecast;
+    unsigned long long lastStallUs;  // PSI cpu "some" total at the previous cycle
+    double lastStallTime;
+    std::unordered_map<int, ProcessLoadHistory> processLoadHistory; // For adaptive scheduling
+    unsigned long long loadUpdates;
+
+    static const size_t MAX_LOAD_HISTORIES = 100;
+    static const int FORECAST_QUANTA = 3; // How far ahead the quantum is sized for
 
     void scheduleWorker();
+    void armPressureTriggers(const SchedulerConfig& config);
     void updateProcessLoad(int pid, double load);
 };
 
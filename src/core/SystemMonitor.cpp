@@ -1,48 +1,67 @@
 #include "SystemMonitor.h"
 #include "Logger.h"
-#include <fstream>
-#include <sstream>
-#include <numeric>
 
 double SystemMonitor::getSystemCPUUsage() {
-    std::ifstream stat("/proc/stat");
-    std::string line;
-    std::getline(stat, line);
-    std::istringstream iss(line);
-    std::string cpu;
-    long user, nice, system, idle;
-    iss >> cpu >> user >> nice >> system >> idle;
-    stat.close();
-    long total = user + nice + system + idle;
-    double usage = (total > 0) ? 100.0 * (total - idle) / total : 0.0;
-    cpuHistory.push_back(usage);
-    if (cpuHistory.size() > 100) cpuHistory.erase(cpuHistory.begin());
+    SystemSample sample;
+    std::lock_guard<std::mutex> lock(cpuMtx);
+    if (sampler && sampler->latest(sample)) {
+        cpuHistory.push(sample.cpu_busy_avg);
+        return sample.cpu_busy_avg;
+    }
+    if (!cpuSampler.sample(lastCPU)) return 0.0;
+    double usage = lastCPU.total.busy;
+    cpuHistory.push(usage);
     return usage;
 }
 
+bool SystemMonitor::sampleCPU(CpuStatSnapshot& out) {
+    std::lock_guard<std::mutex> lock(cpuMtx);
+    if (!cpuSampler.sample(lastCPU)) return false;
+    cpuHistory.push(lastCPU.total.busy);
+    out = lastCPU;
+    return true;
+}
+
 double SystemMonitor::getSystemMemoryUsage() {
-    std::ifstream meminfo("/proc/meminfo");
-    std::string line;
-    long total = 0, free = 0;
-    while (std::getline(meminfo, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        long value;
-        iss >> key >> value;
-        if (key == "MemTotal:") total = value;
-        if (key == "MemFree:") free = value;
-    }
-    meminfo.close();
-    return (total > 0) ? 100.0 * (total - free) / total : 0.0;
+    SystemSample sample;
+    if (sampler && sampler->latest(sample)) return sample.memory.usedPercent();
+    MemSnapshot memory;
+    return MemInfoCache::shared().get(memory) ? memory.usedPercent() : 0.0;
 }
 
 double SystemMonitor::calculateMovingAverageCPU() {
-    if (cpuHistory.empty()) return 0.0;
-    double sum = std::accumulate(cpuHistory.begin(), cpuHistory.end(), 0.0);
-    return sum / cpuHistory.size();
+    std::lock_guard<std::mutex> lock(cpuMtx);
+    return cpuHistory.mean();
 }
 
 void SystemMonitor::logSystemStats() {
-    Logger::log("CPU Usage: " + std::to_string(getSystemCPUUsage()) + "%, Moving Avg: " + std::to_string(calculateMovingAverageCPU()) + "%");
-    Logger::log("Memory Usage: " + std::to_string(getSystemMemoryUsage()) + "%");
+    SystemSample sample;
+    if (sampler && sampler->latest(sample)) {
+        Logger::log("CPU Usage: " + std::to_string(sample.cpu_busy_avg) + "% (iowait " +
+                    std::to_string(sample.cpu.iowait) + "%, steal " + std::to_string(sample.cpu.steal) + "%), " +
+                    std::to_string(sample.online_cpus) + " CPUs, sampled at " + std::to_string(sampler->rate()) + " Hz");
+        Logger::log("Context switches: " + std::to_string(sample.context_switch_rate) + "/s, running: " +
+                    std::to_string(sample.procs_running) + ", blocked: " + std::to_string(sample.procs_blocked) +
+                    ", run-queue wait: " + std::to_string(sample.runqueue.wait_rate) + "ms/s (" +
+                    std::to_string(sample.runqueue.latency_us) + "us per slice)");
+        const MemSnapshot& memory = sample.memory;
+        Logger::log("Memory Usage: " + std::to_string(memory.usedPercent()) + "% (available " +
+                    std::to_string(memory.available / 1024) + " MB), swap " + std::to_string(memory.swapUsedPercent()) + "%");
+        return;
+    }
+    CpuStatSnapshot cpu;
+    if (sampleCPU(cpu)) {
+        Logger::log("CPU Usage: " + std::to_string(cpu.total.busy) + "% (iowait " + std::to_string(cpu.total.iowait) +
+                    "%, steal " + std::to_string(cpu.total.steal) + "%), Moving Avg: " +
+                    std::to_string(calculateMovingAverageCPU()) + "%");
+        Logger::log("Context switches: " + std::to_string(cpu.context_switches) + ", running: " +
+                    std::to_string(cpu.procs_running) + ", blocked: " + std::to_string(cpu.procs_blocked));
+    }
+    MemSnapshot memory;
+    if (sampleMemory(memory)) {
+        Logger::log("Memory Usage: " + std::to_string(memory.usedPercent()) + "% (available " +
+                    std::to_string(memory.available / 1024) + " MB, cached " + std::to_string(memory.cached / 1024) +
+                    " MB, dirty " + std::to_string(memory.dirty / 1024) + " MB), swap " +
+                    std::to_string(memory.swapUsedPercent()) + "%");
+    }
 }
\ No newline at end of file
@@ -2,17 +2,38 @@
 #define SYSTEM_MONITOR_H
 
 #include "types.h"
-#include <vector>
+#include "CpuStatSampler.h"
+#include "MemInfoCache.h"
+#include "RingBuffer.h"
+#include "SystemSampler.h"
+#include <mutex>
 
+// Reads /proc on demand, or serves the latest published sample once attached
+// to a running SystemSampler.
 class SystemMonitor {
 public:
+    SystemMonitor() : sampler(nullptr) {}
+    // The sampler must outlive this monitor. Until it has published, the
+    // monitor keeps reading /proc itself.
+    void attach(const SystemSampler* source) { sampler = source; }
+
+    // Busy % since the previous call on this monitor (since boot on the
+    // first), or the sampler's smoothed busy % when attached.
     double getSystemCPUUsage();
+    // Full /proc/stat delta: per-core loads, context switches, procs_running.
+    bool sampleCPU(CpuStatSnapshot& out);
+    // Share of RAM not available without reclaim (MemTotal - MemAvailable).
     double getSystemMemoryUsage();
+    bool sampleMemory(MemSnapshot& out) { return MemInfoCache::shared().get(out); }
     void logSystemStats();
     double calculateMovingAverageCPU();
 
 private:
-    std::vector<double> cpuHistory;
+    RingBuffer<double, 100> cpuHistory; // Busy % of the last 100 samples
+    CpuStatSampler cpuSampler;
+    CpuStatSnapshot lastCPU;
+    std::mutex cpuMtx;
+    const SystemSampler* sampler;
 };
 
 #endif
\ No newline at end of file
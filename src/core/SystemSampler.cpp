@@ -0,0 +1,98 @@
+#include "SystemSampler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+
+const int SystemSampler::MAX_RATE_HZ;
+const int SystemSampler::DEFAULT_RATE_HZ;
+
+namespace {
+
+const double SMOOTHING_SECONDS = 0.25; // Time constant of cpu_busy_avg
+// /proc/schedstat carries per-domain lines and is far larger than
+// /proc/stat; run-queue rates are not worth reading it at 1 kHz.
+const std::chrono::milliseconds SCHEDSTAT_INTERVAL(10);
+
+}
+
+SystemSampler::SystemSampler() : untickedSeconds(0.0), running(false), rateHz(DEFAULT_RATE_HZ) {}
+
+SystemSampler::~SystemSampler() {
+    stop();
+}
+
+void SystemSampler::start(int rate_hz) {
+    setRate(rate_hz);
+    if (running.exchange(true)) return;
+    worker = std::thread(&SystemSampler::run, this);
+    Logger::log("System sampler started at " + std::to_string(rateHz.load()) + " Hz");
+}
+
+void SystemSampler::setRate(int rate_hz) {
+    rateHz = std::max(1, std::min(MAX_RATE_HZ, rate_hz));
+}
+
+void SystemSampler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMtx);
+        if (!running.exchange(false)) return;
+    }
+    sleepCv.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+// Ticks are scheduled on absolute deadlines so the rate does not drift with
+// the time spent sampling; a tick that falls behind is skipped, not queued.
+void SystemSampler::run() {
+    SystemSample sample = SystemSample();
+    auto next = std::chrono::steady_clock::now();
+    while (running) {
+        sampleOnce(sample);
+        published.store(sample);
+
+        next += std::chrono::microseconds(1000000 / rateHz.load());
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) next = now;
+        std::unique_lock<std::mutex> lock(sleepMtx);
+        sleepCv.wait_until(lock, next, [this]() { return !running; });
+    }
+}
+
+// Jiffies advance at CONFIG_HZ (100-1000 Hz), so at high sampling rates
+// most intervals see no tick at all and their all-zero load means nothing.
+// Those leave the load and average alone, and their time is carried into
+// the next interval that does see a tick.
+void SystemSampler::update(const CpuStatSnapshot& cpu, SystemSample& sample) {
+    double interval = cpu.interval_seconds;
+    sample.context_switch_rate = (interval > 0.0) ? cpu.context_switches / interval : 0.0;
+    sample.fork_rate = (interval > 0.0) ? cpu.forks / interval : 0.0;
+    sample.procs_running = cpu.procs_running;
+    sample.procs_blocked = cpu.procs_blocked;
+    sample.online_cpus = static_cast<unsigned int>(
+        std::count_if(cpu.cores.begin(), cpu.cores.end(), [](const CpuLoad& core) { return core.online; }));
+    if (cpu.since_boot || sample.sequence == 0) {
+        sample.cpu = cpu.total;
+        sample.cpu_busy_avg = cpu.total.busy;
+        untickedSeconds = 0.0;
+        return;
+    }
+    untickedSeconds += interval;
+    if (cpu.jiffies == 0) return;
+    sample.cpu = cpu.total;
+    double alpha = 1.0 - std::exp(-untickedSeconds / SMOOTHING_SECONDS);
+    sample.cpu_busy_avg += alpha * (cpu.total.busy - sample.cpu_busy_avg);
+    untickedSeconds = 0.0;
+}
+
+void SystemSampler::sampleOnce(SystemSample& sample) {
+    if (cpuSampler.sample(cpu)) update(cpu, sample);
+    auto now = std::chrono::steady_clock::now();
+    if (schedSampler.isSupported() && now - lastSchedSample >= SCHEDSTAT_INTERVAL && schedSampler.sample(sched)) {
+        sample.runqueue = sched.total;
+        sample.runqueue_max_wait_rate = sched.max_wait_rate;
+        lastSchedSample = now;
+    }
+    MemInfoCache::shared().get(sample.memory);
+    ++sample.sequence;
+    sample.taken = now;
+}
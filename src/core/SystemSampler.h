@@ -0,0 +1,76 @@
+#ifndef SYSTEM_SAMPLER_H
+#define SYSTEM_SAMPLER_H
+
+#include "CpuStatSampler.h"
+#include "SchedStatSampler.h"
+#include "MemInfoCache.h"
+#include "SeqLock.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// System-wide state as of the sampler's last tick. Trivially copyable so it
+// can be published through a SeqLock.
+struct SystemSample {
+    CpuLoad cpu;                    // Over the last sampler interval only
+    double cpu_busy_avg;            // Busy % smoothed over ~250ms; use this for decisions
+    double context_switch_rate;     // Per second
+    double fork_rate;
+    unsigned long procs_running;
+    unsigned long procs_blocked;
+    unsigned int online_cpus;
+    RunQueueLoad runqueue;          // Summed over CPUs; refreshed at most every 10ms
+    double runqueue_max_wait_rate;  // Busiest single CPU, ms/s
+    MemSnapshot memory;             // Through MemInfoCache, so at most one read per its TTL
+    unsigned long long sequence;    // Samples taken since start()
+    std::chrono::steady_clock::time_point taken;
+};
+
+// One thread reads /proc/stat (and meminfo through the shared cache) at a
+// fixed rate and publishes the result. latest() is a lock-free copy, so
+// callers on the scheduling path never touch procfs themselves.
+class SystemSampler {
+public:
+    static const int MAX_RATE_HZ = 1000;
+    static const int DEFAULT_RATE_HZ = 100;
+
+    SystemSampler();
+    ~SystemSampler();
+    SystemSampler(const SystemSampler&) = delete;
+    SystemSampler& operator=(const SystemSampler&) = delete;
+
+    // Starts the thread, or only changes the rate if it is running.
+    void start(int rate_hz);
+    void setRate(int rate_hz);
+    void stop();
+    bool isRunning() const { return running; }
+    int rate() const { return rateHz; }
+
+    // False until the first sample after start() is published.
+    bool latest(SystemSample& out) const { return published.load(out); }
+
+    // Folds one /proc/stat interval into sample; sampleOnce() is read +
+    // update.
+    void update(const CpuStatSnapshot& cpu, SystemSample& sample);
+
+private:
+    void run();
+    void sampleOnce(SystemSample& sample);
+
+    SeqLock<SystemSample> published;
+    CpuStatSampler cpuSampler;    // Sampler thread only
+    CpuStatSnapshot cpu;
+    double untickedSeconds;       // Since the last interval in which a jiffy elapsed
+    SchedStatSampler schedSampler;
+    SchedStatSnapshot sched;
+    std::chrono::steady_clock::time_point lastSchedSample;
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<int> rateHz;
+    std::mutex sleepMtx;          // Lets stop() cut a sleep short
+    std::condition_variable sleepCv;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#include "TaskstatsClient.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <linux/acct.h>
+#include <linux/taskstats.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Netlink attributes are 4-byte aligned; a request carries one attribute.
+struct GenlRequest {
+    struct nlmsghdr header;
+    struct genlmsghdr genl;
+    char attrs[256];
+};
+
+const struct nlattr* nextAttr(const struct nlattr* attr, size_t& remaining) {
+    size_t len = NLA_ALIGN(attr->nla_len);
+    remaining = (len < remaining) ? remaining - len : 0;
+    return reinterpret_cast<const struct nlattr*>(reinterpret_cast<const char*>(attr) + len);
+}
+
+bool attrFits(const struct nlattr* attr, size_t remaining) {
+    return remaining >= sizeof(struct nlattr) && attr->nla_len >= sizeof(struct nlattr) && attr->nla_len <= remaining;
+}
+
+const void* attrData(const struct nlattr* attr) {
+    return reinterpret_cast<const char*>(attr) + NLA_HDRLEN;
+}
+
+size_t attrLen(const struct nlattr* attr) {
+    return attr->nla_len - NLA_HDRLEN;
+}
+
+}
+
+TaskstatsClient::TaskstatsClient() : sock(-1), family_id(0), seq(0), exitsRegistered(false), buffer(16 * 1024) {}
+
+TaskstatsClient::~TaskstatsClient() {
+    if (exitsRegistered && !cpumask.empty()) {
+        send(TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_DEREGISTER_CPUMASK, cpumask.data(),
+             static_cast<uint16_t>(cpumask.size()));
+    }
+    if (sock != -1) close(sock);
+}
+
+bool TaskstatsClient::isSupported() {
+    static const bool supported = [] {
+        TaskstatsClient client;
+        TaskCounters counters;
+        return client.open() && client.queryTgid(getpid(), counters);
+    }();
+    return supported;
+}
+
+bool TaskstatsClient::open() {
+    if (sock != -1) return true;
+    sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (sock == -1) return false;
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1 || !resolveFamily()) {
+        close(sock);
+        sock = -1;
+        return false;
+    }
+    return true;
+}
+
+bool TaskstatsClient::send(uint8_t cmd, uint16_t attr_type, const void* attr, uint16_t attr_len) {
+    GenlRequest request;
+    memset(&request, 0, sizeof(request));
+    if (static_cast<size_t>(NLA_HDRLEN) + attr_len > sizeof(request.attrs)) return false;
+    request.header.nlmsg_type = family_id ? family_id : GENL_ID_CTRL;
+    request.header.nlmsg_flags = NLM_F_REQUEST;
+    request.header.nlmsg_seq = ++seq;
+    request.genl.cmd = cmd;
+    request.genl.version = family_id ? TASKSTATS_GENL_VERSION : 1;
+    struct nlattr* nla = reinterpret_cast<struct nlattr*>(request.attrs);
+    nla->nla_type = attr_type;
+    nla->nla_len = static_cast<uint16_t>(NLA_HDRLEN + attr_len);
+    memcpy(request.attrs + NLA_HDRLEN, attr, attr_len);
+    request.header.nlmsg_len = static_cast<uint32_t>(NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(nla->nla_len));
+
+    struct sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    return sendto(sock, &request, request.header.nlmsg_len, 0, reinterpret_cast<struct sockaddr*>(&kernel),
+                  sizeof(kernel)) != -1;
+}
+
+bool TaskstatsClient::resolveFamily() {
+    const char name[] = TASKSTATS_GENL_NAME;
+    if (!send(CTRL_CMD_GETFAMILY, CTRL_ATTR_FAMILY_NAME, name, sizeof(name))) return false;
+    ssize_t len = recv(sock, buffer.data(), buffer.size(), 0);
+    if (len <= 0) return false;
+    const struct nlmsghdr* header = reinterpret_cast<const struct nlmsghdr*>(buffer.data());
+    if (!NLMSG_OK(header, static_cast<unsigned int>(len)) || header->nlmsg_type == NLMSG_ERROR) return false;
+    size_t remaining = header->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+    const struct nlattr* attr = reinterpret_cast<const struct nlattr*>(
+        static_cast<const char*>(NLMSG_DATA(header)) + GENL_HDRLEN);
+    for (; attrFits(attr, remaining); attr = nextAttr(attr, remaining)) {
+        if (attr->nla_type == CTRL_ATTR_FAMILY_ID && attrLen(attr) >= sizeof(uint16_t)) {
+            memcpy(&family_id, attrData(attr), sizeof(family_id));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskstatsClient::queryTgid(int tgid, TaskCounters& out) {
+    if (sock == -1) return false;
+    uint32_t id = static_cast<uint32_t>(tgid);
+    if (!send(TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_TGID, &id, sizeof(id))) return false;
+    uint32_t expected = seq;
+    while (true) {
+        ssize_t len = recv(sock, buffer.data(), buffer.size(), 0);
+        if (len <= 0) return false;
+        for (const struct nlmsghdr* header = reinterpret_cast<const struct nlmsghdr*>(buffer.data());
+             NLMSG_OK(header, static_cast<unsigned int>(len)); header = NLMSG_NEXT(header, len)) {
+            if (header->nlmsg_seq != expected) continue; // Late reply to an earlier request
+            if (header->nlmsg_type == NLMSG_ERROR) return false; // ESRCH: the group is gone
+            int reply_tgid = 0;
+            bool group_exited = false;
+            return parseStats(NLMSG_DATA(header), header->nlmsg_len - NLMSG_HDRLEN, out, reply_tgid, group_exited) &&
+                   reply_tgid == tgid;
+        }
+    }
+}
+
+bool TaskstatsClient::registerExitListener() {
+    if (sock == -1) return false;
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    std::string mask = "0-" + std::to_string(cpus > 0 ? cpus - 1 : 0);
+    cpumask.assign(mask.c_str(), mask.c_str() + mask.size() + 1);
+    if (!send(TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_REGISTER_CPUMASK, cpumask.data(),
+              static_cast<uint16_t>(cpumask.size()))) {
+        return false;
+    }
+    int rcvbuf = 1024 * 1024; // Exit bursts arrive while nobody is draining
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    exitsRegistered = true;
+    return true;
+}
+
+void TaskstatsClient::drainExits(std::vector<int>& tgids) {
+    if (!exitsRegistered) return;
+    while (true) {
+        ssize_t len = recv(sock, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (len <= 0) {
+            if (len == -1 && errno == ENOBUFS) continue; // Records were lost; reconciliation catches up
+            return;
+        }
+        for (const struct nlmsghdr* header = reinterpret_cast<const struct nlmsghdr*>(buffer.data());
+             NLMSG_OK(header, static_cast<unsigned int>(len)); header = NLMSG_NEXT(header, len)) {
+            if (header->nlmsg_type != family_id) continue;
+            TaskCounters counters;
+            int tgid = 0;
+            bool group_exited = false;
+            if (parseStats(NLMSG_DATA(header), header->nlmsg_len - NLMSG_HDRLEN, counters, tgid, group_exited) &&
+                group_exited) {
+                tgids.push_back(tgid);
+            }
+        }
+    }
+}
+
+// Replies nest a PID or TGID attribute and the taskstats struct inside an
+// AGGR_PID or AGGR_TGID attribute. Older kernels send a shorter struct;
+// fields we do not receive stay zero. group_exited is set for exit records
+// of the last task of a thread group: an AGGR_TGID record, or an AGGR_PID
+// record flagged AGROUP (single-threaded processes get no AGGR_TGID).
+bool TaskstatsClient::parseStats(const void* payload, size_t len, TaskCounters& out, int& tgid, bool& group_exited) {
+    if (len < GENL_HDRLEN) return false;
+    size_t remaining = len - GENL_HDRLEN;
+    const struct nlattr* attr = reinterpret_cast<const struct nlattr*>(static_cast<const char*>(payload) + GENL_HDRLEN);
+    bool found = false;
+    group_exited = false;
+    for (; attrFits(attr, remaining); attr = nextAttr(attr, remaining)) {
+        if (attr->nla_type != TASKSTATS_TYPE_AGGR_PID && attr->nla_type != TASKSTATS_TYPE_AGGR_TGID) continue;
+        bool aggregate_tgid = attr->nla_type == TASKSTATS_TYPE_AGGR_TGID;
+        size_t nested_remaining = attrLen(attr);
+        const struct nlattr* nested = static_cast<const struct nlattr*>(attrData(attr));
+        for (; attrFits(nested, nested_remaining); nested = nextAttr(nested, nested_remaining)) {
+            if ((nested->nla_type == TASKSTATS_TYPE_PID || nested->nla_type == TASKSTATS_TYPE_TGID) &&
+                attrLen(nested) >= sizeof(uint32_t)) {
+                uint32_t id;
+                memcpy(&id, attrData(nested), sizeof(id));
+                tgid = static_cast<int>(id);
+            } else if (nested->nla_type == TASKSTATS_TYPE_STATS) {
+                struct taskstats stats;
+                memset(&stats, 0, sizeof(stats));
+                memcpy(&stats, attrData(nested), std::min(attrLen(nested), sizeof(stats)));
+                out.utime_us = stats.ac_utime;
+                out.stime_us = stats.ac_stime;
+                out.cpu_delay_ns = stats.cpu_delay_total;
+                out.cpu_run_ns = stats.cpu_run_real_total;
+                out.cpu_count = stats.cpu_count;
+                out.blkio_delay_ns = stats.blkio_delay_total;
+                out.swapin_delay_ns = stats.swapin_delay_total;
+                out.nvcsw = stats.nvcsw;
+                out.nivcsw = stats.nivcsw;
+                if (!aggregate_tgid && (stats.ac_flag & AGROUP) && stats.ac_tgid != 0) {
+                    tgid = static_cast<int>(stats.ac_tgid);
+                    group_exited = true;
+                }
+                found = true;
+            }
+        }
+        if (aggregate_tgid) {
+            group_exited = true;
+            break;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,58 @@
+#ifndef TASKSTATS_CLIENT_H
+#define TASKSTATS_CLIENT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Binary per-process counters from the TASKSTATS genetlink family.
+struct TaskCounters {
+    unsigned long long utime_us;        // Summed over live threads
+    unsigned long long stime_us;
+    unsigned long long cpu_delay_ns;    // Runnable but waiting for a CPU
+    unsigned long long cpu_run_ns;      // On a CPU; with cpu_count, the schedstat counters
+    unsigned long long cpu_count;       // Times scheduled onto a CPU
+    unsigned long long blkio_delay_ns;  // Waiting for block I/O
+    unsigned long long swapin_delay_ns; // Waiting for swap-in
+    unsigned long long nvcsw;           // Voluntary context switches
+    unsigned long long nivcsw;
+};
+
+// Queries TASKSTATS over generic netlink: one request and one binary reply
+// per thread group, no text parsing. Needs CAP_NET_ADMIN, and delay counters
+// stay zero unless the kernel runs with delay accounting (delayacct=on or
+// kernel.task_delayacct=1).
+class TaskstatsClient {
+public:
+    TaskstatsClient();
+    ~TaskstatsClient();
+    TaskstatsClient(const TaskstatsClient&) = delete;
+    TaskstatsClient& operator=(const TaskstatsClient&) = delete;
+
+    bool open();
+    bool isOpen() const { return sock != -1; }
+    bool queryTgid(int tgid, TaskCounters& out);
+
+    // Subscribes this socket to exit records from every CPU. Besides
+    // delivering final counters, a registered listener makes the kernel
+    // keep the counters of exited threads in the thread-group totals.
+    bool registerExitListener();
+    // Non-blocking; appends the thread groups whose exit records arrived.
+    void drainExits(std::vector<int>& tgids);
+
+    static bool isSupported();
+
+private:
+    bool resolveFamily();
+    bool send(uint8_t cmd, uint16_t attr_type, const void* attr, uint16_t attr_len);
+    static bool parseStats(const void* payload, size_t len, TaskCounters& out, int& tgid, bool& group_exited);
+
+    int sock;
+    uint16_t family_id;
+    uint32_t seq;
+    bool exitsRegistered;
+    std::vector<char> cpumask; // "0-N", kept for deregistration
+    std::vector<char> buffer;
+};
+
+#endif
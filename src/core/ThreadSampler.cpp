@@ -0,0 +1,79 @@
+#include "ThreadSampler.h"
+#include "ProcScanner.h"
+#include "ProcStatParser.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+const unsigned long ThreadSampler::STALE_CYCLES;
+
+ThreadSampler::ThreadSampler() : ticks_per_second(sysconf(_SC_CLK_TCK)), cycle(0), direntBuffer(16 * 1024) {
+    proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+ThreadSampler::~ThreadSampler() {
+    if (proc_fd != -1) close(proc_fd);
+}
+
+bool ThreadSampler::listTids(int pid, std::vector<int>& tids) {
+    char path[32];
+    snprintf(path, sizeof(path), "%d/task", pid);
+    int task_fd = openat(proc_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (task_fd == -1) {
+        tids.clear();
+        return false;
+    }
+    bool ok = ProcScanner::listNumericEntries(task_fd, direntBuffer, tids);
+    close(task_fd);
+    return ok;
+}
+
+double ThreadSampler::sample(int pid, std::vector<ThreadSample>& out) {
+    out.clear();
+    if (!listTids(pid, tidBuffer)) return 0.0;
+    auto now = std::chrono::steady_clock::now();
+    double total = 0.0;
+    for (int tid : tidBuffer) {
+        ProcStat stat;
+        if (!ProcStatParser::readTaskAt(proc_fd, pid, tid, stat)) continue;
+        unsigned long long jiffies = stat.utime + stat.stime;
+        double usage = 0.0;
+        auto it = threads.find(tid);
+        if (it != threads.end() && it->second.starttime == stat.starttime) {
+            double elapsed = std::chrono::duration<double>(now - it->second.sampled_at).count();
+            if (elapsed > 0.0 && jiffies >= it->second.jiffies) {
+                usage = 100.0 * (jiffies - it->second.jiffies) / (ticks_per_second * elapsed);
+            }
+        }
+        threads[tid] = ThreadState{stat.starttime, jiffies, now, cycle};
+        out.push_back(ThreadSample{tid, stat.starttime, usage});
+        total += usage;
+    }
+    return total;
+}
+
+bool ThreadSampler::listThreads(int pid, std::vector<ThreadSample>& out) {
+    out.clear();
+    if (!listTids(pid, tidBuffer)) return false;
+    for (int tid : tidBuffer) {
+        ProcStat stat;
+        if (ProcStatParser::readTaskAt(proc_fd, pid, tid, stat)) out.push_back(ThreadSample{tid, stat.starttime, 0.0});
+    }
+    return true;
+}
+
+bool ThreadSampler::isSameThread(int pid, int tid, unsigned long long starttime) {
+    ProcStat stat;
+    return ProcStatParser::readTaskAt(proc_fd, pid, tid, stat) && stat.starttime == starttime;
+}
+
+void ThreadSampler::endCycle() {
+    for (auto it = threads.begin(); it != threads.end();) {
+        if (cycle - it->second.cycle > STALE_CYCLES) {
+            it = threads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ++cycle;
+}
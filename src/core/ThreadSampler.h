@@ -0,0 +1,54 @@
+#ifndef THREAD_SAMPLER_H
+#define THREAD_SAMPLER_H
+
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+struct ThreadSample {
+    int tid;
+    unsigned long long starttime; // With tid, identifies the thread
+    double cpu_usage;             // CPU% since this thread was last sampled
+};
+
+// setpriority(PRIO_PROCESS, pid) and sched_setaffinity(pid) only reach the
+// thread whose TID equals the PID, so thread-level policies need the TIDs
+// and their individual load. Sampling is on demand for selected processes;
+// thread state is keyed by TID and dropped once a TID is not sampled for a
+// few cycles.
+class ThreadSampler {
+public:
+    ThreadSampler();
+    ~ThreadSampler();
+    ThreadSampler(const ThreadSampler&) = delete;
+    ThreadSampler& operator=(const ThreadSampler&) = delete;
+
+    // Lists /proc/[pid]/task and fills one sample per thread; returns the
+    // process total aggregated from the same reads.
+    double sample(int pid, std::vector<ThreadSample>& out);
+    bool listThreads(int pid, std::vector<ThreadSample>& out); // Without CPU deltas
+    // True if tid is still a thread of pid with the given starttime.
+    bool isSameThread(int pid, int tid, unsigned long long starttime);
+    void endCycle();
+
+private:
+    bool listTids(int pid, std::vector<int>& tids);
+
+    struct ThreadState {
+        unsigned long long starttime;
+        unsigned long long jiffies;
+        std::chrono::steady_clock::time_point sampled_at;
+        unsigned long cycle;
+    };
+
+    static const unsigned long STALE_CYCLES = 8;
+
+    int proc_fd;
+    long ticks_per_second;
+    unsigned long cycle;
+    std::unordered_map<int, ThreadState> threads;
+    std::vector<int> tidBuffer;
+    std::vector<char> direntBuffer;
+};
+
+#endif
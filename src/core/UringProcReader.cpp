@@ -0,0 +1,262 @@
+#include "UringProcReader.h"
+#include "ProcScanner.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int uringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(SYS_io_uring_setup, entries, params));
+}
+
+int uringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(SYS_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int uringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(SYS_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+bool probeSupport() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = uringSetup(4, &params);
+    if (fd == -1) {
+        Logger::log("io_uring unavailable: " + std::string(strerror(errno)));
+        return false;
+    }
+    const unsigned ops = 64;
+    std::vector<char> storage(sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    bool supported = uringRegister(fd, IORING_REGISTER_PROBE, probe, ops) == 0;
+    for (unsigned op : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE}) {
+        supported = supported && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    close(fd);
+    if (!supported) Logger::log("io_uring lacks OPENAT/READ/CLOSE support");
+    return supported;
+}
+
+}
+
+const unsigned UringProcReader::RING_ENTRIES;
+const size_t UringProcReader::FILE_BUFFER_SIZE;
+
+bool UringProcReader::isSupported() {
+    static const bool supported = probeSupport();
+    return supported;
+}
+
+UringProcReader::UringProcReader()
+    : ring_fd(-1), sq_ring(MAP_FAILED), cq_ring(MAP_FAILED), sq_ring_size(0), cq_ring_size(0), sqes(nullptr),
+      sqes_size(0), pending(0), submitted(0), files(RING_ENTRIES), buffers(RING_ENTRIES * FILE_BUFFER_SIZE) {
+    if (isSupported() && !setup()) Logger::log("io_uring setup failed: " + std::string(strerror(errno)));
+}
+
+UringProcReader::~UringProcReader() {
+    teardown();
+}
+
+void UringProcReader::teardown() {
+    if (sqes) munmap(sqes, sqes_size);
+    if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+    if (ring_fd != -1) close(ring_fd);
+    sqes = nullptr;
+    sq_ring = cq_ring = MAP_FAILED;
+    ring_fd = -1;
+    pending = 0;
+}
+
+bool UringProcReader::setup() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = uringSetup(RING_ENTRIES, &params);
+    if (fd == -1) return false;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    cq_ring = single_mmap ? sq_ring
+                          : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_map = (cq_ring == MAP_FAILED) ? MAP_FAILED
+                        : mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqe_map == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqe_map);
+
+    char* sq = static_cast<char*>(sq_ring);
+    char* cq = static_cast<char*>(cq_ring);
+    sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring_fd = fd;
+    return true;
+}
+
+io_uring_sqe* UringProcReader::nextSqe() {
+    unsigned tail = *sq_tail + pending;
+    unsigned index = tail & *sq_mask;
+    sq_array[index] = index;
+    ++pending;
+    io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+// Publishes the queued SQEs and blocks until all of them have completed;
+// completion results are written back through user_data (a FileSlot index).
+// io_uring_enter may take fewer SQEs than offered, so the rest are offered
+// again, and the wait only ever covers SQEs the kernel accepted. On failure
+// the ring is torn down, since SQEs left published in it would be submitted
+// by the next call; `submitted` says how many of this batch the kernel took.
+bool UringProcReader::submitAndWait(unsigned count) {
+    __atomic_store_n(sq_tail, *sq_tail + pending, __ATOMIC_RELEASE);
+    unsigned to_submit = pending;
+    pending = 0;
+    submitted = 0;
+    unsigned done = 0;
+    while (done < count) {
+        // A short submit returns without waiting, so asking for every
+        // completion of this call's SQEs never blocks on ones left behind.
+        int rc = uringEnter(ring_fd, to_submit, submitted + to_submit - done, IORING_ENTER_GETEVENTS);
+        if (rc < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) break;
+            rc = 0; // EAGAIN/EBUSY: out of resources until completions are reaped
+        }
+        to_submit -= static_cast<unsigned>(rc);
+        submitted += static_cast<unsigned>(rc);
+        unsigned reaped = done;
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head, ++done) {
+            const io_uring_cqe& cqe = cqes[head & *cq_mask];
+            if (cqe.user_data < files.size()) files[cqe.user_data].bytes = cqe.res;
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        if (rc == 0 && to_submit > 0 && done == reaped && submitted == done) break; // No progress possible
+    }
+    if (done == count) return true;
+    Logger::log("io_uring submission failed: " + std::string(strerror(errno)) + ", reading /proc with syscalls");
+    teardown();
+    return false;
+}
+
+bool UringProcReader::read(int proc_fd, const int* pids, size_t count, bool read_io, ProcSample* out) {
+    if (!ok()) return false;
+    size_t files_per_pid = read_io ? 4 : 3;
+    size_t batch = RING_ENTRIES / files_per_pid;
+    for (size_t begin = 0; begin < count; begin += batch) {
+        size_t n = std::min(batch, count - begin);
+        if (!readBatch(proc_fd, pids + begin, n, read_io, out + begin)) return false;
+    }
+    return true;
+}
+
+bool UringProcReader::readBatch(int proc_fd, const int* pids, size_t count, bool read_io, ProcSample* out) {
+    static const char* const names[] = {"stat", "statm", "schedstat", "io"};
+    size_t files_per_pid = read_io ? 4 : 3;
+    unsigned total = static_cast<unsigned>(count * files_per_pid);
+
+    for (unsigned i = 0; i < total; ++i) {
+        FileSlot& file = files[i];
+        snprintf(file.path, sizeof(file.path), "%d/%s", pids[i / files_per_pid], names[i % files_per_pid]);
+        file.fd = -1;
+        file.bytes = -1;
+        io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = proc_fd;
+        sqe->addr = reinterpret_cast<unsigned long>(file.path);
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = i;
+    }
+    if (!submitAndWait(total)) {
+        // Ring is broken and the caller falls back to syscalls; opens that
+        // completed left their fds in bytes.
+        for (unsigned i = 0; i < total; ++i) {
+            if (files[i].bytes >= 0) close(files[i].bytes);
+        }
+        return false;
+    }
+
+    unsigned reads = 0;
+    for (unsigned i = 0; i < total; ++i) {
+        FileSlot& file = files[i];
+        file.fd = file.bytes;
+        if (file.fd < 0) continue;
+        io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = file.fd;
+        sqe->addr = reinterpret_cast<unsigned long>(&buffers[i * FILE_BUFFER_SIZE]);
+        sqe->len = FILE_BUFFER_SIZE;
+        sqe->user_data = i;
+        ++reads;
+    }
+    if (!submitAndWait(reads)) {
+        for (unsigned i = 0; i < total; ++i) {
+            if (files[i].fd >= 0) close(files[i].fd);
+        }
+        return false;
+    }
+
+    unsigned closes = 0;
+    for (unsigned i = 0; i < total; ++i) {
+        if (files[i].fd < 0) continue;
+        io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = files[i].fd;
+        sqe->user_data = RING_ENTRIES; // Result ignored
+        ++closes;
+    }
+
+    for (size_t p = 0; p < count; ++p) {
+        ProcSample& sample = out[p];
+        const FileSlot* slot = &files[p * files_per_pid];
+        const char* data = &buffers[p * files_per_pid * FILE_BUFFER_SIZE];
+        sample.valid = slot[0].fd >= 0 && slot[0].bytes > 0 &&
+                       ProcStatParser::parse(data, static_cast<size_t>(slot[0].bytes), sample.stat);
+        sample.memory_usage = (slot[1].fd >= 0 && slot[1].bytes > 0)
+                                  ? ProcScanner::parseStatm(data + FILE_BUFFER_SIZE, static_cast<size_t>(slot[1].bytes))
+                                  : 0;
+        sample.read_bytes = 0;
+        sample.write_bytes = 0;
+        sample.counters_only = false;
+        sample.has_delays = false;
+        sample.has_schedstat = false;
+        if (slot[2].fd >= 0 && slot[2].bytes > 0) {
+            ProcScanner::parseSchedstat(data + 2 * FILE_BUFFER_SIZE, static_cast<size_t>(slot[2].bytes), sample);
+        }
+        if (read_io && slot[3].fd >= 0 && slot[3].bytes > 0) {
+            ProcScanner::parseIo(data + 3 * FILE_BUFFER_SIZE, static_cast<size_t>(slot[3].bytes), sample);
+        }
+    }
+    if (submitAndWait(closes)) return true;
+    // CLOSE SQEs were queued in slot order and the kernel takes them in
+    // order, so only those past `submitted` still need closing here.
+    unsigned queued = 0;
+    for (unsigned i = 0; i < total; ++i) {
+        if (files[i].fd >= 0 && queued++ >= submitted) close(files[i].fd);
+    }
+    return false;
+}
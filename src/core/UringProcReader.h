@@ -0,0 +1,68 @@
+#ifndef URING_PROC_READER_H
+#define URING_PROC_READER_H
+
+#include <cstddef>
+#include <vector>
+#include <linux/io_uring.h>
+
+struct ProcSample;
+
+// Reads /proc/[pid]/{stat,statm,schedstat,io} for many PIDs with a handful of
+// io_uring_enter calls: one submission of openat for the whole batch, one
+// of reads and one of closes. Talks to the kernel through the raw
+// syscalls, so no liburing dependency. A ring is single-threaded; use one
+// per thread.
+class UringProcReader {
+public:
+    static const unsigned RING_ENTRIES = 256;
+    static const size_t FILE_BUFFER_SIZE = 1024;
+
+    // True if the kernel has io_uring with OPENAT, READ and CLOSE and it is
+    // not disabled by policy. Probed once per process.
+    static bool isSupported();
+
+    UringProcReader();
+    ~UringProcReader();
+    UringProcReader(const UringProcReader&) = delete;
+    UringProcReader& operator=(const UringProcReader&) = delete;
+
+    bool ok() const { return ring_fd != -1; }
+    // Fills out[0..count); returns false if the ring failed, in which case
+    // the caller should read the same PIDs through plain syscalls.
+    bool read(int proc_fd, const int* pids, size_t count, bool read_io, ProcSample* out);
+
+private:
+    struct FileSlot {
+        char path[24];
+        int fd;
+        int bytes;
+    };
+
+    bool setup();
+    void teardown();
+    io_uring_sqe* nextSqe();
+    bool submitAndWait(unsigned count);
+    bool readBatch(int proc_fd, const int* pids, size_t count, bool read_io, ProcSample* out);
+
+    int ring_fd;
+    void* sq_ring;
+    void* cq_ring;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    io_uring_cqe* cqes;
+    unsigned pending;
+    unsigned submitted; // SQEs the kernel accepted in the last submitAndWait
+    std::vector<FileSlot> files;
+    std::vector<char> buffers;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "WorkingSetEstimator.h"
+#include "FileUtils.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+const size_t WorkingSetEstimator::MAX_SAMPLE_PAGES;
+const size_t WorkingSetEstimator::MAX_SCAN_PAGES;
+
+namespace {
+
+const uint64_t PAGEMAP_PRESENT = 1ULL << 63;
+const uint64_t PAGEMAP_SWAPPED = 1ULL << 62;
+const uint64_t PAGEMAP_PFN_MASK = (1ULL << 55) - 1;
+const size_t PAGEMAP_CHUNK = 512; // Entries per pread, 4KB
+
+const unsigned long PAGE_SIZE_BYTES = static_cast<unsigned long>(sysconf(_SC_PAGESIZE));
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+WorkingSetEstimator::WorkingSetEstimator(const std::string& bitmap_path, const std::string& proc_root)
+    : procRoot(proc_root), entries(PAGEMAP_CHUNK) {
+    bitmap_fd = open(bitmap_path.c_str(), O_RDWR | O_CLOEXEC);
+}
+
+WorkingSetEstimator::~WorkingSetEstimator() {
+    if (bitmap_fd != -1) close(bitmap_fd);
+}
+
+// Every stride-th present page is sampled, with the stride chosen from the
+// resident size so the sample spreads over the whole address space.
+// Mappings without read permission (guard pages, ---p reservations of
+// allocators and runtimes) are skipped, and the walk ends once as many
+// present pages as are resident have been seen.
+bool WorkingSetEstimator::begin(int pid, unsigned long long resident_pages, WorkingSetWindow& out) {
+    out.pid = pid;
+    out.pfns.clear();
+    out.resident_pages = resident_pages;
+    if (bitmap_fd == -1) return false;
+    std::string dir = procRoot + "/" + std::to_string(pid);
+    size_t len = 0;
+    if (!FileUtils::readAll(dir + "/maps", mapsBuffer, len)) return false;
+    int pagemap_fd = open((dir + "/pagemap").c_str(), O_RDONLY | O_CLOEXEC);
+    if (pagemap_fd == -1) return false;
+
+    unsigned long long stride = std::max(1ULL, resident_pages / MAX_SAMPLE_PAGES);
+    unsigned long long present = 0;
+    size_t scanned = 0;
+    const char* end = mapsBuffer.data() + len;
+    for (const char* line = mapsBuffer.data(); line < end && scanned < MAX_SCAN_PAGES && present < resident_pages;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (!eol) eol = end;
+        char* p = nullptr;
+        unsigned long page = strtoul(line, &p, 16) / PAGE_SIZE_BYTES;
+        unsigned long stop = 0;
+        if (p < eol && *p == '-') stop = strtoul(p + 1, &p, 16) / PAGE_SIZE_BYTES;
+        if (p + 1 >= eol || p[1] != 'r') stop = page; // "start-end perms ..."
+        while (page < stop && scanned < MAX_SCAN_PAGES && present < resident_pages && out.pfns.size() < MAX_SAMPLE_PAGES) {
+            size_t count = std::min<size_t>({PAGEMAP_CHUNK, stop - page, MAX_SCAN_PAGES - scanned});
+            ssize_t n = pread(pagemap_fd, entries.data(), count * sizeof(uint64_t),
+                              static_cast<off_t>(page * sizeof(uint64_t)));
+            if (n <= 0) break; // Past the user address space ([vsyscall])
+            size_t got = static_cast<size_t>(n) / sizeof(uint64_t);
+            for (size_t i = 0; i < got && present < resident_pages; ++i) {
+                uint64_t entry = entries[i];
+                if (!(entry & PAGEMAP_PRESENT) || (entry & PAGEMAP_SWAPPED)) continue;
+                uint64_t pfn = entry & PAGEMAP_PFN_MASK;
+                if (present++ % stride == 0 && pfn != 0 && out.pfns.size() < MAX_SAMPLE_PAGES) out.pfns.push_back(pfn);
+            }
+            page += got;
+            scanned += got;
+        }
+        line = eol + 1;
+    }
+    close(pagemap_fd);
+    if (out.pfns.empty()) return false; // Nothing resident, or frame numbers hidden without CAP_SYS_ADMIN
+
+    std::sort(out.pfns.begin(), out.pfns.end());
+    out.pfns.erase(std::unique(out.pfns.begin(), out.pfns.end()), out.pfns.end());
+    out.began = std::chrono::steady_clock::now();
+    return markIdle(out.pfns);
+}
+
+// The bitmap is read and written in aligned 64-bit words, one bit per
+// frame; a written 1 marks the frame idle, a 0 leaves it alone.
+bool WorkingSetEstimator::markIdle(const std::vector<uint64_t>& pfns) {
+    for (size_t i = 0; i < pfns.size();) {
+        uint64_t word = pfns[i] / 64;
+        uint64_t bits = 0;
+        for (; i < pfns.size() && pfns[i] / 64 == word; ++i) bits |= 1ULL << (pfns[i] % 64);
+        if (pwrite(bitmap_fd, &bits, sizeof(bits), static_cast<off_t>(word * sizeof(bits))) != sizeof(bits)) {
+            Logger::log(std::string("Could not mark pages idle: ") + strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WorkingSetEstimator::finish(const WorkingSetWindow& window, WorkingSetEstimate& out) {
+    out = WorkingSetEstimate();
+    if (bitmap_fd == -1 || window.pfns.empty()) return false;
+    size_t idle = 0;
+    for (size_t i = 0; i < window.pfns.size();) {
+        uint64_t word = window.pfns[i] / 64;
+        uint64_t bits = 0;
+        if (pread(bitmap_fd, &bits, sizeof(bits), static_cast<off_t>(word * sizeof(bits))) != sizeof(bits)) return false;
+        for (; i < window.pfns.size() && window.pfns[i] / 64 == word; ++i) {
+            if (bits & (1ULL << (window.pfns[i] % 64))) ++idle;
+        }
+    }
+    out.sampled_pages = window.pfns.size();
+    out.accessed_fraction = static_cast<double>(out.sampled_pages - idle) / out.sampled_pages;
+    out.working_set_kb = static_cast<unsigned long long>(out.accessed_fraction * window.resident_pages *
+                                                         (PAGE_SIZE_BYTES / 1024));
+    out.window_seconds = secondsSince(window.began);
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef WORKING_SET_ESTIMATOR_H
+#define WORKING_SET_ESTIMATOR_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// A sample of one process's resident pages, marked idle when the window
+// began.
+struct WorkingSetWindow {
+    int pid;
+    std::vector<uint64_t> pfns;        // Sorted
+    unsigned long long resident_pages; // When the window began
+    std::chrono::steady_clock::time_point began;
+};
+
+struct WorkingSetEstimate {
+    unsigned long long working_set_kb; // Resident memory touched during the window, extrapolated
+    double accessed_fraction;          // Of the sampled pages
+    size_t sampled_pages;
+    double window_seconds;
+};
+
+// Idle page tracking: begin() looks up the physical frames behind a sample
+// of a process's resident pages in /proc/[pid]/pagemap and sets their bits
+// in /sys/kernel/mm/page_idle/bitmap; any access clears a bit, so at
+// finish() the share still idle is the share the process did not touch.
+// At most MAX_SAMPLE_PAGES are tracked per process, so the cost does not
+// grow with its size. Pages shared with other processes count as touched
+// when anyone touches them. Needs CONFIG_IDLE_PAGE_TRACKING and
+// CAP_SYS_ADMIN (pagemap hides frame numbers otherwise).
+class WorkingSetEstimator {
+public:
+    static const size_t MAX_SAMPLE_PAGES = 2048;
+    static const size_t MAX_SCAN_PAGES = 1 << 20; // pagemap entries read per begin(), 8MB
+
+    explicit WorkingSetEstimator(const std::string& bitmap_path = "/sys/kernel/mm/page_idle/bitmap",
+                                 const std::string& proc_root = "/proc");
+    ~WorkingSetEstimator();
+    WorkingSetEstimator(const WorkingSetEstimator&) = delete;
+    WorkingSetEstimator& operator=(const WorkingSetEstimator&) = delete;
+
+    bool isSupported() const { return bitmap_fd != -1; }
+
+    bool begin(int pid, unsigned long long resident_pages, WorkingSetWindow& out);
+    bool finish(const WorkingSetWindow& window, WorkingSetEstimate& out);
+
+private:
+    bool markIdle(const std::vector<uint64_t>& pfns);
+
+    int bitmap_fd;
+    std::string procRoot;
+    std::vector<char> mapsBuffer;
+    std::vector<uint64_t> entries;
+};
+
+#endif
@@ -1,35 +1,26 @@
 #include "PerformanceTracker.h"
 #include "Logger.h"
-#include <numeric>
 #include <fstream>
 
 void PerformanceTracker::trackCPU(double usage) {
-    cpu_usages.push_back(usage);
-    if (cpu_usages.size() > 1000) cpu_usages.erase(cpu_usages.begin());
+    cpu_usages.push(usage);
     Logger::log("Tracked CPU usage: " + std::to_string(usage) + "%");
 }
 
 void PerformanceTracker::trackMemory(double usage) {
-    memory_usages.push_back(usage);
-    if (memory_usages.size() > 1000) memory_usages.erase(memory_usages.begin());
+    memory_usages.push(usage);
     Logger::log("Tracked Memory usage: " + std::to_string(usage) + "%");
 }
 
-double PerformanceTracker::calculateVariance(const std::vector<double>& data) {
-    if (data.empty()) return 0.0;
-    double mean = std::accumulate(data.begin(), data.end(), 0.0) / data.size();
-    double variance = 0.0;
-    for (double x : data) {
-        variance += (x - mean) * (x - mean);
-    }
-    return variance / data.size();
-}
-
 void PerformanceTracker::generateReport() {
     std::ofstream report("logs/performance_report.json");
     report << "{\n";
-    report << "  \"cpu_variance\": " << calculateVariance(cpu_usages) << ",\n";
-    report << "  \"memory_variance\": " << calculateVariance(memory_usages) << "\n";
+    report << "  \"cpu_mean\": " << cpu_usages.mean() << ",\n";
+    report << "  \"cpu_variance\": " << cpu_usages.variance() << ",\n";
+    report << "  \"cpu_peak\": " << (cpu_usages.empty() ? 0.0 : cpu_usages.max()) << ",\n";
+    report << "  \"memory_mean\": " << memory_usages.mean() << ",\n";
+    report << "  \"memory_variance\": " << memory_usages.variance() << ",\n";
+    report << "  \"memory_peak\": " << (memory_usages.empty() ? 0.0 : memory_usages.max()) << "\n";
     report << "}\n";
     report.close();
     Logger::log("Generated performance report");
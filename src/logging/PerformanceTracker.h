@@ -1,7 +1,7 @@
 #ifndef PERFORMANCE_TRACKER_H
 #define PERFORMANCE_TRACKER_H
 
-#include <vector>
+#include "RingBuffer.h"
 #include <string>
 
 class PerformanceTracker {
@@ -11,9 +11,8 @@ public:
     void generateReport();
 
 private:
-    std::vector<double> cpu_usages;
-    std::vector<double> memory_usages;
-    double calculateVariance(const std::vector<double>& data);
+    RingBuffer<double, 1000> cpu_usages;
+    RingBuffer<double, 1000> memory_usages;
 };
 
 #endif
\ No newline at end of file
@@ -2,8 +2,20 @@
 #include "SystemMonitor.h"
 #include "IPCManager.h"
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <signal.h>
 
 int main(int argc, char* argv[]) {
+    // Blocked before any thread starts so every thread inherits the mask and
+    // SIGINT/SIGTERM reach only the sigwait below; returning from main then
+    // stops scheduling and restores the cpufreq settings.
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
     Scheduler scheduler;
     SystemMonitor monitor;
     IPCManager ipc;
@@ -11,6 +23,8 @@ int main(int argc, char* argv[]) {
     if (argc > 1) {
         std::string arg = argv[1];
         if (arg == "get_cpu") {
+            monitor.getSystemCPUUsage(); // Baseline; the next call covers only the pause
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
             std::cout << monitor.getSystemCPUUsage() << std::endl;
             return 0;
         } else if (arg == "get_mem") {
@@ -22,7 +36,12 @@ int main(int argc, char* argv[]) {
     }
 
     scheduler.startScheduling();
+    monitor.attach(&scheduler.systemSampler());
     monitor.logSystemStats();
     std::cout << "Smart Resource Scheduler running\n";
+    int received = 0;
+    sigwait(&stop_signals, &received);
+    std::cout << "Received " << (received == SIGINT ? "SIGINT" : "SIGTERM") << ", shutting down\n";
+    scheduler.stopScheduling();
     return 0;
 }
\ No newline at end of file
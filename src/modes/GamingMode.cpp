@@ -2,17 +2,17 @@
 #include "Logger.h"
 #include <sched.h>
 
-void GamingMode::apply(const SchedulerConfig& config, ProcessManager& processManager) {
+void GamingMode::apply(const SchedulerConfig& config, ProcessManager& processManager, const ProcessSnapshot& snapshot) {
     Logger::log("Applying Gaming mode with high priority: " + std::to_string(config.priority_high));
-    auto processes = processManager.getRunningProcesses();
-    for (const auto& proc : processes) {
-        processManager.setPriority(proc.pid, config.priority_high);
-        processManager.setCPUAffinity(proc.pid, config.cpu_affinity_cores);
-        processManager.assignToCgroup(proc.pid, config);
-        processManager.migrateToNUMANode(proc.pid, 0); // Prefer NUMA node 0 for low latency
-        optimizeForLowLatency(proc.pid);
-        Logger::log("Optimized PID " + std::to_string(proc.pid) + " for Gaming mode");
-    }
+    snapshot.actionable().forEachSet([&](size_t i) {
+        int pid = snapshot.pids()[i];
+        processManager.setPriority(pid, config.priority_high);
+        processManager.setCPUAffinity(pid, config.cpu_affinity_cores);
+        processManager.assignToCgroup(pid, config);
+        processManager.migrateToNUMANode(pid, 0); // Prefer NUMA node 0 for low latency
+        optimizeForLowLatency(pid);
+        Logger::log("Optimized PID " + std::to_string(pid) + " for Gaming mode");
+    });
 }
 
 void GamingMode::optimizeForLowLatency(int pid) {
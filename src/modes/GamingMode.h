@@ -6,7 +6,7 @@
 
 class GamingMode {
 public:
-    void apply(const SchedulerConfig& config, ProcessManager& processManager);
+    void apply(const SchedulerConfig& config, ProcessManager& processManager, const ProcessSnapshot& snapshot);
     void optimizeForLowLatency(int pid);
 };
 
@@ -1,34 +1,147 @@
 #include "ModeManager.h"
 #include "Logger.h"
+#include "PolicyClassifier.h"
 
-ModeManager::ModeManager() {
+ModeManager::ModeManager() : outlook(), fgWait(), cpuFreqEnabled(false) {
     setMode("Productivity");
 }
 
 void ModeManager::setMode(const std::string& mode) {
-    config = configManager.loadConfig("config/" + mode + "_profile.json");
+    SchedulerConfig loaded = configManager.loadConfig("config/" + mode + "_profile.json");
+    bool applyCpuFreq;
+    {
+        std::lock_guard<std::mutex> lock(configMtx);
+        config = loaded;
+        applyCpuFreq = cpuFreqEnabled;
+    }
+    processManager.configureScanner(loaded);
+    configureEventSource(loaded);
+    if (applyCpuFreq) cpuFreq.apply(loaded);
     Logger::log("Loaded config for mode: " + mode);
 }
 
+void ModeManager::enableCpuFreq() {
+    SchedulerConfig current;
+    {
+        std::lock_guard<std::mutex> lock(configMtx);
+        cpuFreqEnabled = true;
+        current = config;
+    }
+    cpuFreq.apply(current);
+}
+
+void ModeManager::disableCpuFreq() {
+    {
+        std::lock_guard<std::mutex> lock(configMtx);
+        cpuFreqEnabled = false;
+    }
+    cpuFreq.restore();
+}
+
 void ModeManager::applyScheduling() {
-    adjustPrioritiesDynamically();
-    processManager.adjustPriorities(config);
-    memoryManager.monitorMemory(config);
+    SchedulerConfig cycleConfig;
+    LoadOutlook expected;
+    {
+        std::lock_guard<std::mutex> lock(configMtx);
+        cycleConfig = config;
+        expected = outlook;
+    }
+    MemInfoCache::shared().refresh(); // Everything below reads this cycle's meminfo from the cache
+    ProcessSnapshot snapshot = processManager.captureSnapshot();
+    measureForegroundWait(snapshot, cycleConfig);
+    adjustPrioritiesDynamically(snapshot, cycleConfig, expected);
+    processManager.adjustPriorities(cycleConfig, snapshot);
+    memoryManager.monitorMemory(cycleConfig, snapshot);
     systemMonitor.logSystemStats();
 }
 
-void ModeManager::adjustPrioritiesDynamically() {
-    auto processes = processManager.getRunningProcesses();
-    for (auto& proc : processes) {
-        if (proc.cpu_usage > 75.0) {
-            proc.cpu_usage += 5; // Boost priority for high CPU usage
-        } else if (proc.memory_usage > config.memory_threshold_mb * 1024) {
-            proc.cpu_usage -= 5; // Lower priority for high memory usage
+void ModeManager::configureEventSource(const SchedulerConfig& config) {
+    processManager.setReconcileInterval(config.reconcile_interval_ms);
+    if (config.use_proc_events && !processManager.eventSourceActive()) {
+        if (!processManager.enableEventSource([this](int pid) { onProcessExec(pid); })) {
+            Logger::log("Falling back to periodic /proc scans");
+        }
+    } else if (!config.use_proc_events && processManager.eventSourceActive()) {
+        processManager.disableEventSource();
+    }
+}
+
+// Runs on the proc connector thread, right after the kernel reports the exec.
+void ModeManager::onProcessExec(int pid) {
+    processManager.placeProcess(pid, getConfig());
+    Logger::log("Placed new process " + std::to_string(pid) + " on exec");
+}
+
+void ModeManager::adjustPrioritiesDynamically(const ProcessSnapshot& snapshot, const SchedulerConfig& config,
+                                              const LoadOutlook& expected) {
+    // Start boosting busy processes earlier when saturation is confidently on its way.
+    double hot_threshold = 75.0;
+    if (expected.cpu > 80.0) hot_threshold -= 15.0 * expected.confidence;
+    DecisionBitmap hot = PolicyClassifier::above(snapshot.cpuUsage(), hot_threshold) & snapshot.actionable();
+    DecisionBitmap heavy = (PolicyClassifier::above(snapshot.memoryUsage(), config.memory_threshold_mb * 1024L) &
+                            snapshot.actionable()).andNot(hot);
+    hot.forEachSet([&](size_t i) {
+        double cpu_usage = snapshot.cpuUsage()[i] + 5; // Boost priority for high CPU usage
+        Logger::log("Dynamic priority adjustment for PID " + std::to_string(snapshot.pids()[i]) + ", effective load " + std::to_string(cpu_usage));
+    });
+    heavy.forEachSet([&](size_t i) {
+        double cpu_usage = snapshot.cpuUsage()[i] - 5; // Lower priority for high memory usage
+        Logger::log("Dynamic priority adjustment for PID " + std::to_string(snapshot.pids()[i]) + ", effective load " + std::to_string(cpu_usage));
+    });
+    // Run-queue wait (schedstat, any backend) and I/O delay (TASKSTATS only):
+    // time spent waiting rather than running. 200ms/s is a fifth of the interval.
+    DecisionBitmap starved = PolicyClassifier::above(snapshot.waitRate(), 200.0) & snapshot.actionable();
+    DecisionBitmap stalled = PolicyClassifier::above(snapshot.ioDelay(), 20.0) & snapshot.actionable();
+    starved.forEachSet([&](size_t i) {
+        Logger::log("PID " + std::to_string(snapshot.pids()[i]) + " waited " + std::to_string(snapshot.waitRate()[i]) +
+                    "ms/s for a CPU (" + std::to_string(snapshot.schedLatency()[i]) + "us per timeslice)");
+    });
+    stalled.forEachSet([&](size_t i) {
+        Logger::log("PID " + std::to_string(snapshot.pids()[i]) + " waited " + std::to_string(snapshot.ioDelay()[i]) +
+                    "% of the interval on I/O or swap-in");
+    });
+}
+
+// The quantum controller targets the worst foreground wait rather than total
+// utilisation: a busy machine is fine while the interactive work still gets
+// on a CPU promptly.
+void ModeManager::measureForegroundWait(const ProcessSnapshot& snapshot, const SchedulerConfig& config) {
+    ForegroundWait measured = ForegroundWait();
+    size_t worst = ProcessSnapshot::npos;
+    snapshot.hasSchedstat().forEachSet([&](size_t i) {
+        if (snapshot.classes()[i] != ProcessClass::FOREGROUND) return;
+        ++measured.processes;
+        if (worst == ProcessSnapshot::npos || snapshot.waitRate()[i] > measured.max_wait_rate) {
+            worst = i;
+            measured.max_wait_rate = snapshot.waitRate()[i];
+            measured.latency_us = snapshot.schedLatency()[i];
         }
-        Logger::log("Dynamic priority adjustment for PID " + std::to_string(proc.pid));
+    });
+    if (measured.processes && measured.max_wait_rate > config.foreground_wait_target_ms) {
+        Logger::log("Foreground PID " + std::to_string(snapshot.pids()[worst]) + " waited " +
+                    std::to_string(measured.max_wait_rate) + "ms/s for a CPU, target " +
+                    std::to_string(config.foreground_wait_target_ms) + "ms/s");
     }
+    std::lock_guard<std::mutex> lock(configMtx);
+    fgWait = measured;
+}
+
+ForegroundWait ModeManager::foregroundWait() const {
+    std::lock_guard<std::mutex> lock(configMtx);
+    return fgWait;
+}
+
+void ModeManager::setTimeQuantum(int quantum_ms) {
+    std::lock_guard<std::mutex> lock(configMtx);
+    config.time_quantum_ms = quantum_ms;
+}
+
+void ModeManager::setLoadOutlook(const LoadOutlook& value) {
+    std::lock_guard<std::mutex> lock(configMtx);
+    outlook = value;
 }
 
 SchedulerConfig ModeManager::getConfig() const {
+    std::lock_guard<std::mutex> lock(configMtx);
     return config;
 }
\ No newline at end of file
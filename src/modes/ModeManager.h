@@ -6,21 +6,49 @@
 #include "ProcessManager.h"
 #include "MemoryManager.h"
 #include "SystemMonitor.h"
+#include "LoadForecaster.h"
+#include "CpuFreqManager.h"
+#include <mutex>
+
+// Run-queue wait of the foreground class over the last scheduling cycle.
+struct ForegroundWait {
+    double max_wait_rate;   // ms/s of the worst-off foreground process
+    double latency_us;      // Its mean wait per timeslice
+    size_t processes;       // Foreground processes with schedstat data
+};
 
 class ModeManager {
 public:
     ModeManager();
     void setMode(const std::string& mode);
+    // cpufreq settings are written only between these two, so a ModeManager
+    // built to answer a query leaves sysfs alone.
+    void enableCpuFreq();
+    void disableCpuFreq(); // Restores the original settings
     void applyScheduling();
     SchedulerConfig getConfig() const;
+    void setTimeQuantum(int quantum_ms);
+    void setLoadOutlook(const LoadOutlook& value);
+    ForegroundWait foregroundWait() const;
+    void setScanThreadPool(ThreadPool* pool) { processManager.setScanThreadPool(pool); }
+    void setSystemSampler(const SystemSampler* sampler) { systemMonitor.attach(sampler); }
 
 private:
     SchedulerConfig config;
+    mutable std::mutex configMtx;
+    LoadOutlook outlook;        // Guarded by configMtx
+    ForegroundWait fgWait;      // Guarded by configMtx
+    bool cpuFreqEnabled;        // Guarded by configMtx
     ProcessManager processManager;
     MemoryManager memoryManager;
     SystemMonitor systemMonitor;
+    CpuFreqManager cpuFreq;     // Restores the original settings when destroyed
     ConfigManager configManager;
-    void adjustPrioritiesDynamically();
+    void adjustPrioritiesDynamically(const ProcessSnapshot& snapshot, const SchedulerConfig& config,
+                                     const LoadOutlook& expected);
+    void measureForegroundWait(const ProcessSnapshot& snapshot, const SchedulerConfig& config);
+    void configureEventSource(const SchedulerConfig& config);
+    void onProcessExec(int pid);
 };
 
 #endif
\ No newline at end of file
@@ -1,14 +1,16 @@
 #include "PowerSavingMode.h"
 #include "Logger.h"
+#include "PolicyClassifier.h"
 
-void PowerSavingMode::apply(const SchedulerConfig& config, ProcessManager& processManager) {
+void PowerSavingMode::apply(const SchedulerConfig& config, ProcessManager& processManager, const ProcessSnapshot& snapshot) {
     Logger::log("Applying Power-Saving mode with low priority: " + std::to_string(config.priority_low));
-    auto processes = processManager.getRunningProcesses();
-    for (const auto& proc : processes) {
-        processManager.setPriority(proc.pid, config.priority_low);
-        processManager.assignToCgroup(proc.pid, config);
-        if (proc.cpu_usage > 10.0) {
-            processManager.pauseProcess(proc.pid);
+    DecisionBitmap active = PolicyClassifier::above(snapshot.cpuUsage(), 10.0);
+    const auto& pids = snapshot.pids();
+    snapshot.actionable().forEachSet([&](size_t i) {
+        processManager.setPriority(pids[i], config.priority_low);
+        processManager.assignToCgroup(pids[i], config);
+        if (active.test(i)) {
+            processManager.pauseProcess(pids[i], snapshot.startTimes()[i]);
         }
-    }
+    });
 }
\ No newline at end of file
@@ -1,15 +1,17 @@
 #include "ProductivityMode.h"
 #include "Logger.h"
+#include "PolicyClassifier.h"
 
-void ProductivityMode::apply(const SchedulerConfig& config, ProcessManager& processManager) {
+void ProductivityMode::apply(const SchedulerConfig& config, ProcessManager& processManager, const ProcessSnapshot& snapshot) {
     Logger::log("Applying Productivity mode with balanced priority: " + std::to_string(config.priority_high));
-    auto processes = processManager.getRunningProcesses();
-    for (const auto& proc : processes) {
-        if (proc.cpu_usage < 30.0) {
-            processManager.setPriority(proc.pid, config.priority_low);
+    DecisionBitmap light = PolicyClassifier::below(snapshot.cpuUsage(), 30.0);
+    const auto& pids = snapshot.pids();
+    snapshot.actionable().forEachSet([&](size_t i) {
+        if (light.test(i)) {
+            processManager.setPriority(pids[i], config.priority_low);
         } else {
-            processManager.setPriority(proc.pid, config.priority_high);
+            processManager.setPriority(pids[i], config.priority_high);
         }
-        processManager.assignToCgroup(proc.pid, config);
-    }
+        processManager.assignToCgroup(pids[i], config);
+    });
 }
\ No newline at end of file
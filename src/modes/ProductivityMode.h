@@ -6,7 +6,7 @@
 
 class ProductivityMode {
 public:
-    void apply(const SchedulerConfig& config, ProcessManager& processManager);
+    void apply(const SchedulerConfig& config, ProcessManager& processManager, const ProcessSnapshot& snapshot);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock for a trivially copyable value. The writer
+// never waits; readers take no lock, make no syscalls and retry only if a
+// store overlapped their copy. The value is kept as relaxed atomic words so
+// the overlapping copy is not a data race.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies its value word by word");
+
+public:
+    SeqLock() : sequence(0) {
+        for (auto& word : words) word.store(0, std::memory_order_relaxed);
+    }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Only one thread may store.
+    void store(const T& value) {
+        unsigned long long buf[WORDS] = {};
+        memcpy(buf, &value, sizeof(T));
+        unsigned long long seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed); // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(buf[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Returns false if nothing has been stored yet.
+    bool load(T& out) const {
+        unsigned long long buf[WORDS];
+        unsigned long long before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            while (before & 1) before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) buf[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while (before != after);
+        if (before == 0) return false;
+        memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    // Number of completed stores.
+    unsigned long long version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(unsigned long long) - 1) / sizeof(unsigned long long);
+
+    std::atomic<unsigned long long> sequence;
+    std::atomic<unsigned long long> words[WORDS];
+};
+
+#endif
@@ -14,6 +14,7 @@ public:
     void enqueue(std::function<void()> task);
     void stop();
     void scaleThreads(size_t new_size);
+    size_t size() const { return max_threads; }
 
 private:
     std::vector<std::thread> workers;
@@ -18,6 +18,35 @@ SchedulerConfig ConfigManager::loadConfig(const std::string& file_path) {
     config.cgroup_cpu_shares = j["cgroup_cpu_shares"];
     config.cgroup_memory_limit_mb = j["cgroup_memory_limit_mb"];
     config.ipc_queue_size = j["ipc_queue_size"];
+    config.use_proc_events = j.value("use_proc_events", true);
+    config.reconcile_interval_ms = j.value("reconcile_interval_ms", 5000);
+    config.proc_reader = j.value("proc_reader", std::string("io_uring"));
+    config.sample_process_io = j.value("sample_process_io", false);
+    config.thread_policy = j.value("thread_policy", std::string("process"));
+    config.hot_thread_threshold = j.value("hot_thread_threshold", 20.0);
+    config.sampling_warm_interval = j.value("sampling_warm_interval", 1);
+    config.sampling_idle_interval = j.value("sampling_idle_interval", 1);
+    config.sampling_hot_threshold = j.value("sampling_hot_threshold", 5.0);
+    config.excluded_processes = j.value("excluded_processes", std::vector<std::string>());
+    config.psi_window_ms = j.value("psi_window_ms", 1000);
+    config.psi_cpu_stall_ms = j.value("psi_cpu_stall_ms", 150);
+    config.psi_memory_stall_ms = j.value("psi_memory_stall_ms", 100);
+    config.psi_io_stall_ms = j.value("psi_io_stall_ms", 150);
+    config.calm_interval_ms = j.value("calm_interval_ms", 1000);
+    config.sampler_rate_hz = j.value("sampler_rate_hz", 100);
+    config.foreground_wait_target_ms = j.value("foreground_wait_target_ms", 50);
+    config.cpufreq_governor = j.value("cpufreq_governor", "");
+    config.cpufreq_energy_preference = j.value("cpufreq_energy_preference", "");
+    config.cpufreq_min_khz = j.value("cpufreq_min_khz", 0);
+    config.cpufreq_max_khz = j.value("cpufreq_max_khz", 0);
+    config.reclaim_advice = j.value("reclaim_advice", "off");
+    config.reclaim_trigger_percent = j.value("reclaim_trigger_percent", 85.0);
+    config.reclaim_budget_mb = j.value("reclaim_budget_mb", 128);
+    config.proactive_reclaim_mb = j.value("proactive_reclaim_mb", 0);
+    config.reclaim_headroom_percent = j.value("reclaim_headroom_percent", 15.0);
+    config.memory_rollups_per_cycle = j.value("memory_rollups_per_cycle", 64);
+    config.working_set_window_ms = j.value("working_set_window_ms", 0);
+    config.working_set_processes_per_cycle = j.value("working_set_processes_per_cycle", 16);
     validateConfig(config);
     Logger::log("Loaded config from " + file_path);
     return config;
@@ -32,6 +61,50 @@ void ConfigManager::validateConfig(const SchedulerConfig& config) {
         Logger::log("Invalid time_quantum_ms: " + std::to_string(config.time_quantum_ms));
         throw std::runtime_error("Invalid time_quantum_ms");
     }
+    if (config.psi_window_ms < 500 || config.psi_window_ms > 10000) {
+        Logger::log("Invalid psi_window_ms: " + std::to_string(config.psi_window_ms));
+        throw std::runtime_error("Invalid psi_window_ms");
+    }
+    for (int stall_ms : {config.psi_cpu_stall_ms, config.psi_memory_stall_ms, config.psi_io_stall_ms}) {
+        if (stall_ms < 0 || stall_ms >= config.psi_window_ms) {
+            Logger::log("Invalid PSI stall threshold: " + std::to_string(stall_ms) + "ms");
+            throw std::runtime_error("Invalid PSI stall threshold");
+        }
+    }
+    if (config.sampler_rate_hz < 1 || config.sampler_rate_hz > 1000) {
+        Logger::log("Invalid sampler_rate_hz: " + std::to_string(config.sampler_rate_hz));
+        throw std::runtime_error("Invalid sampler_rate_hz");
+    }
+    if (config.foreground_wait_target_ms < 1 || config.foreground_wait_target_ms > 1000) {
+        Logger::log("Invalid foreground_wait_target_ms: " + std::to_string(config.foreground_wait_target_ms));
+        throw std::runtime_error("Invalid foreground_wait_target_ms");
+    }
+    if (config.cpufreq_min_khz < 0 || config.cpufreq_max_khz < 0 ||
+        (config.cpufreq_min_khz && config.cpufreq_max_khz && config.cpufreq_min_khz > config.cpufreq_max_khz)) {
+        Logger::log("Invalid cpufreq limits: " + std::to_string(config.cpufreq_min_khz) + "-" +
+                    std::to_string(config.cpufreq_max_khz) + " kHz");
+        throw std::runtime_error("Invalid cpufreq limits");
+    }
+    if (config.reclaim_advice != "off" && config.reclaim_advice != "cold" && config.reclaim_advice != "pageout") {
+        Logger::log("Invalid reclaim_advice: " + config.reclaim_advice);
+        throw std::runtime_error("Invalid reclaim_advice");
+    }
+    if (config.reclaim_trigger_percent < 0.0 || config.reclaim_trigger_percent > 100.0 || config.reclaim_budget_mb < 0) {
+        Logger::log("Invalid reclaim trigger or budget: " + std::to_string(config.reclaim_trigger_percent) + "%, " +
+                    std::to_string(config.reclaim_budget_mb) + "MB");
+        throw std::runtime_error("Invalid reclaim settings");
+    }
+    if (config.proactive_reclaim_mb < 0 || config.reclaim_headroom_percent < 0.0 ||
+        config.reclaim_headroom_percent > 100.0) {
+        Logger::log("Invalid proactive reclaim: " + std::to_string(config.proactive_reclaim_mb) + "MB below " +
+                    std::to_string(config.reclaim_headroom_percent) + "% available");
+        throw std::runtime_error("Invalid proactive reclaim settings");
+    }
+    if (config.memory_rollups_per_cycle < 0 || config.working_set_window_ms < 0 ||
+        config.working_set_processes_per_cycle < 0) {
+        Logger::log("Invalid memory accounting settings");
+        throw std::runtime_error("Invalid memory accounting settings");
+    }
 }
 
 void ConfigManager::reloadConfigIfChanged(const std::string& file_path) {
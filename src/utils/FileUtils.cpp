@@ -0,0 +1,33 @@
+#include "FileUtils.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool FileUtils::readAll(const std::string& path, std::vector<char>& buffer, size_t& len) {
+    len = 0;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return false;
+    if (buffer.size() < 4096) buffer.resize(4096);
+    while (true) {
+        ssize_t n = read(fd, buffer.data() + len, buffer.size() - len);
+        if (n < 0) {
+            int saved_errno = errno;
+            close(fd);
+            errno = saved_errno;
+            return false;
+        }
+        if (n == 0) break;
+        len += static_cast<size_t>(n);
+        if (len == buffer.size()) buffer.resize(buffer.size() * 2);
+    }
+    close(fd);
+    return true;
+}
+
+bool FileUtils::readAll(const std::string& path, std::string& out) {
+    thread_local std::vector<char> buffer;
+    size_t len = 0;
+    if (!readAll(path, buffer, len)) return false;
+    out.assign(buffer.data(), len);
+    return true;
+}
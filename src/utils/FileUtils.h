@@ -0,0 +1,18 @@
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Whole-file reads for procfs, sysfs and cgroupfs. Their files report a
+// size of 0, so they are read until EOF into a buffer that grows as needed.
+class FileUtils {
+public:
+    // Fills buffer[0..len); the buffer is kept for reuse and never shrinks.
+    // On failure errno is the one from open() or read().
+    static bool readAll(const std::string& path, std::vector<char>& buffer, size_t& len);
+    static bool readAll(const std::string& path, std::string& out);
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "ProcStatParser.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Parses one space-separated signed decimal field and advances p past it.
+bool nextField(const char*& p, const char* end, long long& value) {
+    while (p < end && *p == ' ') ++p;
+    if (p >= end) return false;
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9') return false;
+    unsigned long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + static_cast<unsigned long long>(*p - '0');
+        ++p;
+    }
+    value = negative ? -static_cast<long long>(v) : static_cast<long long>(v);
+    return true;
+}
+
+}
+
+bool ProcStatParser::parse(const char* buf, size_t len, ProcStat& out) {
+    const char* end = buf + len;
+    const char* open = static_cast<const char*>(memchr(buf, '(', len));
+    if (!open) return false;
+    const char* rparen = end;
+    while (rparen > open && *(rparen - 1) != ')') --rparen;
+    if (rparen == open) return false;
+    --rparen; // points at the last ')'
+
+    long long value;
+    const char* p = buf;
+    if (!nextField(p, open, value)) return false;
+    out.pid = static_cast<int>(value);
+
+    size_t comm_len = static_cast<size_t>(rparen - open - 1);
+    if (comm_len >= sizeof(out.comm)) comm_len = sizeof(out.comm) - 1;
+    memcpy(out.comm, open + 1, comm_len);
+    out.comm[comm_len] = '\0';
+
+    p = rparen + 1;
+    while (p < end && *p == ' ') ++p;
+    if (p >= end) return false;
+    out.state = *p++;
+
+    // Fields 4..41; anything past policy is ignored.
+    for (int field = 4; field <= 41; ++field) {
+        if (!nextField(p, end, value)) return false;
+        switch (field) {
+            case 4: out.ppid = static_cast<int>(value); break;
+            case 5: out.pgrp = static_cast<int>(value); break;
+            case 6: out.session = static_cast<int>(value); break;
+            case 7: out.tty_nr = static_cast<int>(value); break;
+            case 8: out.tpgid = static_cast<int>(value); break;
+            case 9: out.flags = static_cast<unsigned int>(value); break;
+            case 14: out.utime = static_cast<unsigned long long>(value); break;
+            case 15: out.stime = static_cast<unsigned long long>(value); break;
+            case 18: out.priority = static_cast<long>(value); break;
+            case 19: out.nice = static_cast<long>(value); break;
+            case 20: out.num_threads = static_cast<long>(value); break;
+            case 22: out.starttime = static_cast<unsigned long long>(value); break;
+            case 24: out.rss = static_cast<long>(value); break;
+            case 39: out.processor = static_cast<int>(value); break;
+            case 40: out.rt_priority = static_cast<unsigned int>(value); break;
+            case 41: out.policy = static_cast<unsigned int>(value); break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+bool ProcStatParser::read(int pid, ProcStat& out) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[BUFFER_SIZE];
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return false;
+    return parse(buf, static_cast<size_t>(n), out);
+}
+
+bool ProcStatParser::readAt(int proc_fd, int pid, ProcStat& out) {
+    char path[24];
+    snprintf(path, sizeof(path), "%d/stat", pid);
+    return readPathAt(proc_fd, path, out);
+}
+
+bool ProcStatParser::readTaskAt(int proc_fd, int pid, int tid, ProcStat& out) {
+    char path[48];
+    snprintf(path, sizeof(path), "%d/task/%d/stat", pid, tid);
+    return readPathAt(proc_fd, path, out);
+}
+
+bool ProcStatParser::readPathAt(int dir_fd, const char* path, ProcStat& out) {
+    int fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char buf[BUFFER_SIZE];
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    close(fd);
+    if (n <= 0) return false;
+    return parse(buf, static_cast<size_t>(n), out);
+}
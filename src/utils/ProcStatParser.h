@@ -0,0 +1,47 @@
+#ifndef PROC_STAT_PARSER_H
+#define PROC_STAT_PARSER_H
+
+#include <cstddef>
+
+// Numeric fields of /proc/[pid]/stat we care about (see proc(5) for numbering).
+struct ProcStat {
+    int pid;
+    char comm[16];
+    char state;                   // field 3
+    int ppid;                     // field 4
+    int pgrp;                     // field 5
+    int session;                  // field 6
+    int tty_nr;                   // field 7
+    int tpgid;                    // field 8
+    unsigned int flags;           // field 9, PF_* flags
+    unsigned long long utime;     // field 14, clock ticks
+    unsigned long long stime;     // field 15, clock ticks
+    long priority;                // field 18
+    long nice;                    // field 19
+    long num_threads;             // field 20
+    unsigned long long starttime; // field 22, clock ticks since boot
+    long rss;                     // field 24, pages
+    int processor;                // field 39
+    unsigned int rt_priority;     // field 40
+    unsigned int policy;          // field 41
+};
+
+class ProcStatParser {
+public:
+    static const size_t BUFFER_SIZE = 1024;
+
+    // Parses a stat line without allocating. comm may contain spaces and
+    // parentheses, so fields are located relative to the last ')'.
+    static bool parse(const char* buf, size_t len, ProcStat& out);
+    // Reads /proc/[pid]/stat into a stack buffer with a single read().
+    static bool read(int pid, ProcStat& out);
+    // Same, relative to an open /proc directory fd (no path concatenation).
+    static bool readAt(int proc_fd, int pid, ProcStat& out);
+    // /proc/[pid]/task/[tid]/stat, for per-thread counters.
+    static bool readTaskAt(int proc_fd, int pid, int tid, ProcStat& out);
+
+private:
+    static bool readPathAt(int dir_fd, const char* path, ProcStat& out);
+};
+
+#endif
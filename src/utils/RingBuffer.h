@@ -0,0 +1,142 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Fixed-capacity history of the last N values. push() overwrites the oldest
+// value once full and keeps sum, sum of squares, min, max and an EWMA up to
+// date, so every statistic is O(1) instead of a pass over the history.
+//
+// Min and max come from monotonic queues of push sequence numbers: each
+// value enters and leaves each queue at most once. Floating-point sums are
+// recomputed from the stored values once per wrap so rounding error from
+// repeated add/subtract does not accumulate.
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0, "RingBuffer needs a capacity");
+    static_assert(std::is_arithmetic<T>::value, "RingBuffer keeps numeric statistics");
+
+public:
+    // alpha weighs the newest value in ewma(); the first push seeds it.
+    explicit RingBuffer(double alpha = 0.2) : alpha(alpha) { clear(); }
+
+    void push(T value) {
+        unsigned long long seq = pushed;
+        if (count == N) {
+            T evicted = values[seq % N];
+            total -= evicted;
+            squares -= static_cast<double>(evicted) * evicted;
+            minQueue.dropExpired(seq - N);
+            maxQueue.dropExpired(seq - N);
+        } else {
+            ++count;
+        }
+        values[seq % N] = value;
+        ++pushed;
+        total += value;
+        squares += static_cast<double>(value) * value;
+        minQueue.push(values, seq, [](T kept, T added) { return kept < added; });
+        maxQueue.push(values, seq, [](T kept, T added) { return kept > added; });
+        average = (pushed == 1) ? value : alpha * value + (1.0 - alpha) * average;
+        if (std::is_floating_point<T>::value && pushed % N == 0) resum();
+    }
+
+    void clear() {
+        count = 0;
+        pushed = 0;
+        total = 0.0;
+        squares = 0.0;
+        average = 0.0;
+        minQueue.clear();
+        maxQueue.clear();
+    }
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+
+    // 0 is the oldest retained value, size() - 1 the newest.
+    T operator[](size_t i) const { return values[(pushed - count + i) % N]; }
+    T newest() const { return values[(pushed - 1) % N]; }
+
+    // All statistics cover the retained window, except ewma() which spans
+    // every value pushed since the last clear(). Callers check empty() first.
+    double sum() const { return total; }
+    double mean() const { return count ? total / count : 0.0; }
+    double variance() const {
+        if (!count) return 0.0;
+        double m = mean();
+        double v = squares / count - m * m;
+        return v > 0.0 ? v : 0.0;
+    }
+    T min() const { return values[minQueue.front() % N]; }
+    T max() const { return values[maxQueue.front() % N]; }
+    double ewma() const { return average; }
+
+    // Copies the window oldest-first into out, which has room for size()
+    // values, in at most two contiguous runs. Returns the number copied.
+    size_t copyTo(T* out) const {
+        size_t start = (pushed - count) % N;
+        size_t first = (start + count <= N) ? count : N - start;
+        std::copy(values.begin() + start, values.begin() + start + first, out);
+        std::copy(values.begin(), values.begin() + (count - first), out + first);
+        return count;
+    }
+
+    std::vector<T> snapshot() const {
+        std::vector<T> out(count);
+        copyTo(out.data());
+        return out;
+    }
+
+private:
+    // Sequence numbers whose values are monotonic from front to back; the
+    // front is the window's extreme.
+    struct MonotonicQueue {
+        std::array<unsigned long long, N> seqs;
+        size_t head;
+        size_t length;
+
+        void clear() { head = 0; length = 0; }
+        unsigned long long front() const { return seqs[head]; }
+        void dropExpired(unsigned long long seq) {
+            if (length && seqs[head] == seq) {
+                head = (head + 1) % N;
+                --length;
+            }
+        }
+        template <typename Keep>
+        void push(const std::array<T, N>& values, unsigned long long seq, Keep keep) {
+            T added = values[seq % N];
+            while (length && !keep(values[seqs[(head + length - 1) % N] % N], added)) --length;
+            seqs[(head + length) % N] = seq;
+            ++length;
+        }
+    };
+
+    void resum() {
+        total = 0.0;
+        squares = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            total += values[i];
+            squares += static_cast<double>(values[i]) * values[i];
+        }
+    }
+
+    std::array<T, N> values;
+    size_t count;
+    unsigned long long pushed; // Values pushed since clear(); the next one's sequence number
+    double total;
+    double squares;
+    double average;
+    double alpha;
+    MonotonicQueue minQueue;
+    MonotonicQueue maxQueue;
+};
+
+#endif
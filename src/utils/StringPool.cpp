@@ -0,0 +1,31 @@
+#include "StringPool.h"
+#include <algorithm>
+#include <iterator>
+
+StringPool::StringPool() : sweepAt(1024) {}
+
+InternedString StringPool::intern(const std::string& value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = strings.find(value);
+    if (it != strings.end()) {
+        if (InternedString existing = it->second.lock()) return existing;
+    } else {
+        if (strings.size() >= sweepAt) sweep();
+        it = strings.emplace(value, std::weak_ptr<const std::string>()).first;
+    }
+    InternedString interned = std::make_shared<const std::string>(value);
+    it->second = interned;
+    return interned;
+}
+
+size_t StringPool::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return strings.size();
+}
+
+void StringPool::sweep() {
+    for (auto it = strings.begin(); it != strings.end();) {
+        it = it->second.expired() ? strings.erase(it) : std::next(it);
+    }
+    sweepAt = std::max<size_t>(1024, strings.size() * 2);
+}
@@ -0,0 +1,31 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Equal strings interned in the same pool share one allocation, so two
+// InternedStrings are equal exactly when their pointers are.
+using InternedString = std::shared_ptr<const std::string>;
+
+// Deduplicates strings that many processes share (comm, exe, cgroup path).
+// The pool only holds weak references; a string is freed once the last
+// process or rule using it lets go, and its slot is swept on a later intern.
+class StringPool {
+public:
+    StringPool();
+    InternedString intern(const std::string& value);
+    InternedString intern(const char* data, size_t len) { return intern(std::string(data, len)); }
+    size_t size() const;
+
+private:
+    void sweep();
+
+    mutable std::mutex mtx;
+    std::unordered_map<std::string, std::weak_ptr<const std::string>> strings;
+    size_t sweepAt; // Map size that triggers the next sweep of expired entries
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef FAKE_TREE_H
+#define FAKE_TREE_H
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A scratch directory under /tmp standing in for sysfs, cgroupfs or procfs.
+// Paths are relative to it and start with '/'; everything under it is
+// removed when the tree is destroyed.
+class FakeTree {
+public:
+    explicit FakeTree(const std::string& prefix) {
+        std::string pattern = "/tmp/" + prefix + "XXXXXX";
+        char* made = mkdtemp(&pattern[0]);
+        assert(made != nullptr);
+        dir = made;
+    }
+
+    ~FakeTree() {
+        // Depth-first and without following links, so a symlink to a
+        // directory goes and its target is removed once, from inside.
+        nftw(dir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    FakeTree(const FakeTree&) = delete;
+    FakeTree& operator=(const FakeTree&) = delete;
+
+    const std::string& root() const { return dir; }
+    std::string path(const std::string& relative) const { return dir + relative; }
+
+    void makeDir(const std::string& relative) const {
+        int rc = mkdir(path(relative).c_str(), 0755);
+        assert(rc == 0);
+        (void)rc;
+    }
+
+    void link(const std::string& target, const std::string& relative) const {
+        int rc = symlink(target.c_str(), path(relative).c_str());
+        assert(rc == 0);
+        (void)rc;
+    }
+
+    void write(const std::string& relative, const std::string& value) const {
+        std::ofstream out(path(relative), std::ios::binary | std::ios::trunc);
+        out << value;
+        assert(out.good());
+    }
+
+    std::string readLine(const std::string& relative) const {
+        std::string value;
+        std::getline(std::ifstream(path(relative)), value);
+        return value;
+    }
+
+private:
+    static int removeEntry(const char* path, const struct stat*, int type, struct FTW*) {
+        return (type == FTW_DP) ? rmdir(path) : unlink(path);
+    }
+
+    std::string dir;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "CgroupReclaimer.h"
+#include "FakeTree.h"
+#include "Logger.h"
+#include <cassert>
+#include <string>
+
+void setRefaults(FakeTree& tree, unsigned long long anon, unsigned long long file) {
+    tree.write("/cg/background.slice/memory.stat", "anon 1048576\nfile 0\nworkingset_refault_anon " + std::to_string(anon) +
+                                                       "\nworkingset_refault_file " + std::to_string(file) +
+                                                       "\nworkingset_activate_anon 0\n");
+}
+
+void testHeadroomAndPressure(FakeTree& tree) {
+    SchedulerConfig config = SchedulerConfig();
+    config.proactive_reclaim_mb = 16;
+    config.reclaim_headroom_percent = 20.0;
+    CgroupReclaimer reclaimer(tree.path("/cg"), tree.path("/proc"));
+    std::vector<std::string> cgroups = {"/background.slice"};
+    // Plenty available and no direct reclaim: nothing is written.
+    assert(reclaimer.step(cgroups, config, 50.0) == 0);
+    assert(tree.readLine("/cg/background.slice/memory.reclaim").empty());
+    // Short of headroom at 10% PSI: 16MB doubled.
+    assert(reclaimer.step(cgroups, config, 10.0) == 32u << 20);
+    assert(tree.readLine("/cg/background.slice/memory.reclaim") == std::to_string(32u << 20));
+    // Direct reclaim started: doubled again even with headroom.
+    tree.write("/proc/vmstat", "pgscan_kswapd 500\npgscan_direct 150\npgscan_direct_throttle 0\n");
+    assert(reclaimer.step(cgroups, config, 50.0) == 64u << 20);
+    Logger::log("CgroupReclaimer pressure test passed");
+}
+
+void testRefaultsBackOff(FakeTree& tree) {
+    SchedulerConfig config = SchedulerConfig();
+    config.proactive_reclaim_mb = 16;
+    config.reclaim_headroom_percent = 20.0;
+    CgroupReclaimer reclaimer(tree.path("/cg"), tree.path("/proc"));
+    std::vector<std::string> cgroups = {"/background.slice"};
+    setRefaults(tree, 1000, 1000);
+    assert(reclaimer.step(cgroups, config, 10.0) == 32u << 20);
+    // Half of what was taken came straight back: the amount halves.
+    setRefaults(tree, 1000 + 2048, 1000 + 2048);
+    assert(reclaimer.step(cgroups, config, 10.0) == 16u << 20);
+    assert(reclaimer.state("/background.slice")->scale == 0.5);
+    // Quiet refaults let it recover step by step.
+    assert(reclaimer.step(cgroups, config, 10.0) > 16u << 20);
+    assert(reclaimer.state("/background.slice")->scale == 0.625);
+    // A cgroup with no background processes left is forgotten.
+    reclaimer.step({}, config, 10.0);
+    assert(reclaimer.state("/background.slice") == nullptr);
+    Logger::log("CgroupReclaimer back-off test passed");
+}
+
+void testCapsAndUnsupported(FakeTree& tree) {
+    SchedulerConfig config = SchedulerConfig();
+    config.proactive_reclaim_mb = 16;
+    config.reclaim_headroom_percent = 20.0;
+    CgroupReclaimer reclaimer(tree.path("/cg"), tree.path("/proc"));
+    tree.write("/cg/background.slice/memory.current", "8388608\n"); // 8MB: at most 1MB per cycle
+    assert(reclaimer.step({"/background.slice"}, config, 10.0) == 1u << 20);
+    tree.makeDir("/cg/old.slice"); // No memory.reclaim before Linux 5.19
+    tree.write("/cg/old.slice/memory.current", "1073741824\n");
+    assert(reclaimer.step({"/old.slice"}, config, 10.0) == 0);
+    config.proactive_reclaim_mb = 0;
+    assert(reclaimer.step({"/background.slice"}, config, 1.0) == 0);
+    Logger::log("CgroupReclaimer cap test passed");
+}
+
+void addProcess(ProcessSnapshot::Builder& builder, int pid, const InternedString& cgroup, ProcessClass process_class) {
+    auto identity = std::make_shared<ProcessIdentity>();
+    identity->cgroup = cgroup;
+    ProcessInfo info = ProcessInfo();
+    info.pid = pid;
+    info.identity = identity;
+    info.process_class = process_class;
+    builder.add(info);
+}
+
+// A background job in the shell's session scope must not get the
+// foreground's pages reclaimed with it.
+void testMixedCgroupsSkipped(FakeTree& tree) {
+    SchedulerConfig config = SchedulerConfig();
+    config.proactive_reclaim_mb = 16;
+    config.reclaim_headroom_percent = 20.0;
+    CgroupReclaimer reclaimer(tree.path("/cg"), tree.path("/proc"));
+    InternedString background = std::make_shared<const std::string>("/background.slice");
+    InternedString session = std::make_shared<const std::string>("/session.scope");
+    ProcessSnapshot::Builder builder;
+    addProcess(builder, 100, background, ProcessClass::BACKGROUND);
+    addProcess(builder, 200, session, ProcessClass::BACKGROUND);
+    addProcess(builder, 201, session, ProcessClass::FOREGROUND);
+    tree.write("/cg/background.slice/memory.current", "1073741824\n");
+    assert(reclaimer.update(config, builder.build(std::chrono::steady_clock::now()), 10.0) > 0);
+    assert(reclaimer.state("/background.slice") != nullptr);
+    assert(reclaimer.state("/session.scope") == nullptr);
+    assert(tree.readLine("/cg/session.scope/memory.reclaim").empty());
+    Logger::log("CgroupReclaimer mixed cgroup test passed");
+}
+
+// cgroup2 files under <root>/cg and procfs files under <root>/proc.
+int main() {
+    FakeTree tree("cgroup_reclaim_test");
+    for (const char* path : {"/cg", "/cg/background.slice", "/cg/session.scope", "/proc", "/proc/pressure"}) {
+        tree.makeDir(path);
+    }
+    tree.write("/cg/background.slice/memory.current", "1073741824\n"); // 1GB
+    tree.write("/cg/background.slice/memory.reclaim", "");
+    tree.write("/cg/session.scope/memory.current", "1073741824\n");
+    tree.write("/cg/session.scope/memory.reclaim", "");
+    setRefaults(tree, 0, 0);
+    tree.write("/proc/pressure/memory", "some avg10=10.00 avg60=5.00 avg300=1.00 total=123456\n"
+                                        "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    tree.write("/proc/vmstat", "pgscan_kswapd 500\npgscan_direct 100\npgscan_direct_throttle 0\n");
+
+    testHeadroomAndPressure(tree);
+    testRefaultsBackOff(tree);
+    testCapsAndUnsupported(tree);
+    testMixedCgroupsSkipped(tree);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "CpuFreqManager.h"
+#include "FakeTree.h"
+#include "Logger.h"
+#include <cassert>
+#include <string>
+
+void testApplyWritesOnlyChanges(FakeTree& tree) {
+    CpuFreqManager manager(tree.root());
+    assert(manager.policyCount() == 2);
+    SchedulerConfig config = SchedulerConfig();
+    config.cpufreq_governor = "performance";
+    config.cpufreq_energy_preference = "performance";
+    config.cpufreq_min_khz = 3500000;
+    config.cpufreq_max_khz = 4000000;
+    // Governor on both policies, preference on policy0 only, floor on both.
+    assert(manager.apply(config) == 7);
+    assert(tree.readLine("/cpufreq/policy0/scaling_governor") == "performance");
+    assert(tree.readLine("/cpufreq/policy0/energy_performance_preference") == "performance");
+    assert(tree.readLine("/cpufreq/policy2/scaling_min_freq") == "3500000");
+    assert(tree.readLine("/cpufreq/policy2/scaling_max_freq") == "4000000");
+    assert(manager.apply(config) == 0);
+
+    // Unset attributes return to what was found; unknown values are refused.
+    config = SchedulerConfig();
+    config.cpufreq_governor = "ondemand";
+    assert(manager.apply(config) == 5);
+    assert(tree.readLine("/cpufreq/policy0/scaling_governor") == "performance");
+    assert(tree.readLine("/cpufreq/policy0/energy_performance_preference") == "balance_power");
+    assert(tree.readLine("/cpufreq/policy0/scaling_min_freq") == "800000");
+    Logger::log("CpuFreqManager apply test passed");
+}
+
+void testRestoreOnDestruction(FakeTree& tree) {
+    {
+        CpuFreqManager manager(tree.root());
+        SchedulerConfig config = SchedulerConfig();
+        config.cpufreq_governor = "performance";
+        config.cpufreq_energy_preference = "power";
+        config.cpufreq_max_khz = 2000000;
+        manager.apply(config);
+        assert(tree.readLine("/cpufreq/policy2/scaling_max_freq") == "2000000");
+    }
+    assert(tree.readLine("/cpufreq/policy0/scaling_governor") == "powersave");
+    assert(tree.readLine("/cpufreq/policy2/scaling_governor") == "powersave");
+    assert(tree.readLine("/cpufreq/policy0/energy_performance_preference") == "balance_power");
+    assert(tree.readLine("/cpufreq/policy2/scaling_max_freq") == "3000000");
+    Logger::log("CpuFreqManager restore test passed");
+}
+
+// The originals are read when the manager is built, not at the first write,
+// by which time something else may have changed them.
+void testOriginalsReadAtConstruction(FakeTree& tree) {
+    {
+        CpuFreqManager manager(tree.root());
+        tree.write("/cpufreq/policy2/scaling_max_freq", "2500000\n");
+        SchedulerConfig config = SchedulerConfig();
+        config.cpufreq_max_khz = 2000000;
+        assert(manager.apply(config) == 2);
+    }
+    assert(tree.readLine("/cpufreq/policy0/scaling_max_freq") == "3000000");
+    assert(tree.readLine("/cpufreq/policy2/scaling_max_freq") == "3000000");
+    Logger::log("CpuFreqManager snapshot test passed");
+}
+
+void testMissingTree(FakeTree& tree) {
+    CpuFreqManager manager(tree.path("/nonexistent"));
+    assert(!manager.isSupported());
+    SchedulerConfig config = SchedulerConfig();
+    config.cpufreq_governor = "performance";
+    assert(manager.apply(config) == 0);
+    Logger::log("CpuFreqManager missing tree test passed");
+}
+
+// cpu0 and cpu1 share policy0 through symlinks, as on real hardware;
+// cpu2 has its own policy from a driver without energy preferences.
+// sysfs attributes read back with a trailing newline.
+int main() {
+    FakeTree tree("cpufreq_test");
+    for (const char* path : {"/cpufreq", "/cpufreq/policy0", "/cpufreq/policy2", "/cpu0", "/cpu1", "/cpu2"}) {
+        tree.makeDir(path);
+    }
+    tree.link("../cpufreq/policy0", "/cpu0/cpufreq");
+    tree.link("../cpufreq/policy0", "/cpu1/cpufreq");
+    tree.link("../cpufreq/policy2", "/cpu2/cpufreq");
+    for (const char* policy : {"/cpufreq/policy0/", "/cpufreq/policy2/"}) {
+        std::string p = policy;
+        tree.write(p + "scaling_governor", "powersave\n");
+        tree.write(p + "scaling_available_governors", "performance powersave\n");
+        tree.write(p + "scaling_min_freq", "800000\n");
+        tree.write(p + "scaling_max_freq", "3000000\n");
+    }
+    tree.write("/cpufreq/policy0/energy_performance_preference", "balance_power\n");
+    tree.write("/cpufreq/policy0/energy_performance_available_preferences",
+               "default performance balance_performance balance_power power\n");
+
+    testApplyWritesOnlyChanges(tree);
+    testRestoreOnDestruction(tree);
+    testOriginalsReadAtConstruction(tree);
+    testMissingTree(tree);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "CpuStatSampler.h"
+#include "Logger.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+static const char FIRST[] =
+    "cpu  1000 0 500 8000 100 0 0 0 0 0\n"
+    "cpu0 500 0 250 4000 50 0 0 0 0 0\n"
+    "cpu1 500 0 250 4000 50 0 0 0 0 0\n"
+    "intr 123456 0 0 0\n"
+    "ctxt 10000\n"
+    "btime 1700000000\n"
+    "processes 500\n"
+    "procs_running 2\n"
+    "procs_blocked 0\n";
+
+static const char SECOND[] =
+    "cpu  1150 10 540 8100 150 20 30 0 40 0\n"
+    "cpu0 600 10 270 4000 50 20 30 0 40 0\n"
+    "cpu1 550 0 270 4100 100 0 0 0 0 0\n"
+    "intr 123999 0 0 0\n"
+    "ctxt 12500\n"
+    "btime 1700000000\n"
+    "processes 520\n"
+    "procs_running 5\n"
+    "procs_blocked 1\n";
+
+bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-6;
+}
+
+void testDeltasBetweenSamples() {
+    CpuStatSampler sampler;
+    CpuStatSnapshot out;
+    assert(sampler.update(FIRST, strlen(FIRST), 0.0, out));
+    assert(out.since_boot);
+    assert(near(out.total.busy, 100.0 * 1500 / 9600));
+
+    assert(sampler.update(SECOND, strlen(SECOND), 1.0, out));
+    assert(!out.since_boot);
+    // Deltas: user 150 + nice 10, system 40, idle 100, iowait 50, irq 20 + softirq 30 = 400
+    assert(near(out.total.user, 40.0));
+    assert(near(out.total.system, 10.0));
+    assert(near(out.total.iowait, 12.5));
+    assert(near(out.total.irq, 12.5));
+    assert(near(out.total.busy, 62.5));
+    assert(out.context_switches == 2500);
+    assert(out.forks == 20);
+    assert(out.procs_running == 5);
+    assert(out.procs_blocked == 1);
+
+    assert(out.cores.size() == 2);
+    assert(near(out.cores[0].busy, 100.0)); // No idle time on cpu0
+    assert(near(out.cores[1].iowait, 100.0 * 50 / 220));
+    assert(out.cores[0].online && out.cores[1].online);
+}
+
+// A CPU missing from a sample is reported offline; when it returns its
+// load covers the time since it was last seen, not since boot.
+void testOfflineCpu() {
+    CpuStatSampler sampler;
+    CpuStatSnapshot out;
+    sampler.update(FIRST, strlen(FIRST), 0.0, out);
+    static const char ONLY_CPU0[] =
+        "cpu  1100 0 500 8100 100 0 0 0 0 0\n"
+        "cpu0 600 0 250 4000 50 0 0 0 0 0\n";
+    assert(sampler.update(ONLY_CPU0, strlen(ONLY_CPU0), 1.0, out));
+    assert(out.cores[0].online && !out.cores[1].online);
+
+    static const char BACK[] =
+        "cpu  1100 0 500 8200 100 0 0 0 0 0\n"
+        "cpu0 600 0 250 4050 50 0 0 0 0 0\n"
+        "cpu1 500 0 250 4050 50 0 0 0 0 0\n";
+    assert(sampler.update(BACK, strlen(BACK), 1.0, out));
+    assert(out.cores[1].online && near(out.cores[1].busy, 0.0)); // Only idle time since FIRST
+    Logger::log("CpuStatSampler offline test passed");
+}
+
+void testLiveSample() {
+    CpuStatSampler sampler;
+    CpuStatSnapshot out;
+    assert(sampler.sample(out));
+    assert(sampler.sample(out));
+    assert(!out.since_boot);
+    assert(!out.cores.empty());
+    assert(out.total.busy >= 0.0 && out.total.busy <= 100.0);
+    assert(out.procs_running >= 1); // This thread
+}
+
+int main() {
+    testDeltasBetweenSamples();
+    testOfflineCpu();
+    testLiveSample();
+    Logger::log("CpuStatSampler test passed");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "LoadForecaster.h"
+#include "Logger.h"
+#include <cassert>
+#include <cmath>
+#include <random>
+
+bool near(double a, double b, double tolerance) {
+    return std::fabs(a - b) < tolerance;
+}
+
+// A steady climb is extrapolated: the forecast leads the current value.
+void testRampIsExtrapolated() {
+    LoadForecaster forecaster;
+    assert(forecaster.confidence() == 0.0);
+    double t = 0.0;
+    for (int i = 0; i < 200; ++i, t += 0.1) forecaster.update(10.0 + 2.0 * t, t); // +2%/s
+    double now = 10.0 + 2.0 * (t - 0.1);
+    assert(near(forecaster.trend(), 2.0, 0.1));
+    assert(near(forecaster.forecast(0.0), now, 0.5));
+    assert(near(forecaster.forecast(5.0), now + 10.0, 1.0));
+    assert(forecaster.confidence() > 0.9);
+    assert(forecaster.forecast(1000.0) == 100.0); // Clamped to a percentage
+    Logger::log("LoadForecaster ramp test passed");
+}
+
+void testFlatLoadHasNoTrend() {
+    LoadForecaster forecaster;
+    for (int i = 0; i < 50; ++i) forecaster.update(42.0, i * 0.05);
+    assert(near(forecaster.forecast(1.0), 42.0, 1e-9));
+    assert(near(forecaster.confidence(), 1.0, 1e-9));
+    Logger::log("LoadForecaster flat test passed");
+}
+
+// Load that jumps around at random cannot be forecast; confidence says so.
+void testNoiseLowersConfidence() {
+    LoadForecaster forecaster;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> load(0.0, 100.0);
+    for (int i = 0; i < 200; ++i) forecaster.update(load(rng), i * 0.1);
+    assert(forecaster.confidence() < 0.2);
+    Logger::log("LoadForecaster noise test passed");
+}
+
+void testGapsAndWarmup() {
+    LoadForecaster forecaster;
+    for (int i = 0; i < 20; ++i) forecaster.update(50.0 + i, i * 0.1);
+    assert(forecaster.confidence() > 0.0);
+    forecaster.update(80.0, 1.9); // Same instant as the last update: ignored
+    assert(forecaster.samples() == 20);
+    forecaster.update(10.0, 100.0); // Long gap: starts over
+    assert(forecaster.samples() == 1);
+    assert(forecaster.level() == 10.0 && forecaster.trend() == 0.0);
+    assert(forecaster.confidence() == 0.0);
+    for (size_t i = 1; i <= LoadForecaster::WARMUP_SAMPLES; ++i) forecaster.update(10.0, 100.0 + i * 0.1);
+    assert(forecaster.confidence() > 0.0);
+    Logger::log("LoadForecaster gap test passed");
+}
+
+int main() {
+    testRampIsExtrapolated();
+    testFlatLoadHasNoTrend();
+    testNoiseLowersConfidence();
+    testGapsAndWarmup();
+    return 0;
+}
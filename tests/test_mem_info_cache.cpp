@@ -0,0 +1,75 @@
+#include "MemInfoCache.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+static const char MEMINFO[] =
+    "MemTotal:       16000000 kB\n"
+    "MemFree:          500000 kB\n"
+    "MemAvailable:    8000000 kB\n"
+    "Buffers:          200000 kB\n"
+    "Cached:          7000000 kB\n"
+    "SwapCached:        10000 kB\n"
+    "Active(anon):    3000000 kB\n"
+    "Inactive(file):  4000000 kB\n"
+    "SwapTotal:       4000000 kB\n"
+    "SwapFree:        3000000 kB\n"
+    "Dirty:             12345 kB\n"
+    "AnonPages:       5000000 kB\n"
+    "Shmem:            300000 kB\n"
+    "SReclaimable:     400000 kB\n"
+    "HugePages_Total:       0\n"
+    "Hugepagesize:       2048 kB\n";
+
+// Linux before 3.14 has no MemAvailable line.
+static const char OLD_MEMINFO[] =
+    "MemTotal:       16000000 kB\n"
+    "MemFree:          500000 kB\n"
+    "Buffers:          200000 kB\n"
+    "Cached:          7000000 kB\n"
+    "Shmem:            300000 kB\n"
+    "SReclaimable:     400000 kB\n";
+
+void testParse() {
+    MemSnapshot memory;
+    assert(MemInfoCache::parse(MEMINFO, strlen(MEMINFO), memory));
+    assert(memory.total == 16000000 && memory.free == 500000 && memory.available == 8000000);
+    assert(memory.has_available);
+    assert(memory.cached == 7000000 && memory.swap_cached == 10000);
+    assert(memory.active_anon == 3000000 && memory.inactive_file == 4000000);
+    assert(memory.dirty == 12345 && memory.anon_pages == 5000000 && memory.shmem == 300000);
+    assert(memory.usedPercent() == 50.0);     // Not 96.875%, which MemFree would claim
+    assert(memory.swapUsedPercent() == 25.0);
+    assert(memory.writeback == 0);            // Absent fields stay 0
+
+    assert(MemInfoCache::parse(OLD_MEMINFO, strlen(OLD_MEMINFO), memory));
+    assert(!memory.has_available);
+    assert(memory.available == 500000 + 200000 + 7000000 + 400000 - 300000);
+
+    assert(!MemInfoCache::parse("garbage\n", 8, memory));
+    Logger::log("MemInfoCache parse test passed");
+}
+
+void testCache() {
+    MemInfoCache cache;
+    cache.setTtl(std::chrono::milliseconds(200));
+    MemSnapshot first, second;
+    assert(cache.get(first));
+    assert(first.total > 0 && first.available <= first.total);
+    assert(cache.get(second));
+    assert(second.taken == first.taken); // Served from the cache
+    assert(cache.refresh(second));
+    assert(second.taken > first.taken);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    MemSnapshot third;
+    assert(cache.get(third));
+    assert(third.taken > second.taken);  // Expired and re-read
+    Logger::log("MemInfoCache TTL test passed");
+}
+
+int main() {
+    testParse();
+    testCache();
+    return 0;
+}
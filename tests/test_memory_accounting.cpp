@@ -0,0 +1,147 @@
+#include "MemoryAccounting.h"
+#include "WorkingSetEstimator.h"
+#include "ProcessManager.h"
+#include "ProcScanner.h"
+#include "FakeTree.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+void testStatmIsResident() {
+    const char statm[] = "262144 1536 512 10 0 2048 0\n";
+    assert(ProcScanner::parseStatm(statm, sizeof(statm) - 1) == 1536 * (sysconf(_SC_PAGESIZE) / 1024));
+    Logger::log("statm resident test passed");
+}
+
+void testParseSmapsRollup() {
+    const char rollup[] =
+        "55d0c0a00000-7ffd5a1f2000 ---p 00000000 00:00 0                          [rollup]\n"
+        "Rss:               10240 kB\n"
+        "Pss:                6144 kB\n"
+        "Pss_Dirty:          3072 kB\n"
+        "Pss_Anon:           4096 kB\n"
+        "Pss_File:           2048 kB\n"
+        "Pss_Shmem:             0 kB\n"
+        "Shared_Clean:       8192 kB\n"
+        "Shared_Dirty:          0 kB\n"
+        "Private_Clean:         0 kB\n"
+        "Private_Dirty:      2048 kB\n"
+        "Referenced:        10240 kB\n"
+        "Anonymous:          4096 kB\n"
+        "Swap:                512 kB\n"
+        "SwapPss:             256 kB\n"
+        "Locked:                0 kB\n";
+    MemoryFootprint footprint;
+    assert(MemoryAccounting::parseSmapsRollup(rollup, sizeof(rollup) - 1, footprint));
+    assert(footprint.rss == 10240 && footprint.pss == 6144);
+    assert(footprint.pss_anon == 4096 && footprint.pss_file == 2048);
+    assert(footprint.private_dirty == 2048 && footprint.anonymous == 4096);
+    assert(footprint.swap == 512 && footprint.swap_pss == 256);
+    assert(!MemoryAccounting::parseSmapsRollup("", 0, footprint));
+    Logger::log("smaps_rollup parse test passed");
+}
+
+// New processes are read first; the per-cycle budget bounds the reads.
+void testIncrementalAccounting() {
+    MemoryAccounting accounting;
+    MemoryFootprint self;
+    if (!accounting.readRollup(getpid(), self)) return; // smaps_rollup needs Linux 4.14
+    assert(self.rss > 0 && self.pss > 0);
+
+    SchedulerConfig config = SchedulerConfig();
+    config.memory_rollups_per_cycle = 2;
+    ProcessManager pm;
+    ProcessSnapshot snapshot = pm.captureSnapshot();
+    accounting.update(config, snapshot);
+    assert(accounting.size() <= 2);
+    size_t first = accounting.size();
+    accounting.update(config, snapshot);
+    assert(accounting.size() <= first + 2);
+    config.memory_rollups_per_cycle = 100000;
+    accounting.update(config, snapshot);
+    ProcessMemory memory;
+    ProcessKey key = {getpid(), snapshot.startTimes()[snapshot.indexOf(getpid())]};
+    assert(accounting.find(key, memory) && memory.footprint.rss > 0);
+    Logger::log("MemoryAccounting incremental test passed");
+}
+
+// Failed reads count against the budget, and do not hold back the rows
+// after them.
+void testBudgetCountsAttempts() {
+    FakeTree tree("rollup_budget_test");
+    tree.makeDir("/102");
+    tree.write("/102/smaps_rollup", "00400000-7ffd0000 ---p 00000000 00:00 0 [rollup]\nRss: 2048 kB\nPss: 1024 kB\n");
+    ProcessSnapshot::Builder builder;
+    for (int pid : {100, 101, 102}) { // 100 and 101 are unreadable
+        ProcessInfo info = ProcessInfo();
+        info.pid = pid;
+        info.process_class = ProcessClass::SESSION;
+        builder.add(info);
+    }
+    ProcessSnapshot snapshot = builder.build(std::chrono::steady_clock::now());
+    MemoryAccounting accounting(tree.root(), tree.path("/no_bitmap"));
+    SchedulerConfig config = SchedulerConfig();
+    config.memory_rollups_per_cycle = 2;
+    accounting.update(config, snapshot);
+    assert(accounting.size() == 0);
+    accounting.update(config, snapshot);
+    ProcessMemory memory;
+    assert(accounting.find(ProcessKey{102, 0}, memory) && memory.footprint.pss == 1024);
+    Logger::log("MemoryAccounting budget test passed");
+}
+
+// pagemap, maps and the idle bitmap are plain files here; "touching" a page
+// is clearing its bit, as the kernel does on access. Pages behind the ---p
+// reservation and past the resident count are present in pagemap but must
+// not be sampled.
+void testWorkingSetOnFakeTree() {
+    FakeTree tree("working_set_test");
+    tree.makeDir("/42");
+    long page = sysconf(_SC_PAGESIZE);
+    std::ostringstream maps;
+    maps << std::hex << 8 * page << "-" << 16 * page << " ---p 00000000 00:00 0 \n"
+         << 16 * page << "-" << 32 * page << " rw-p 00000000 00:00 0 \n"
+         << 32 * page << "-" << 40 * page << " r--p 00000000 00:00 0 \n";
+    tree.write("/42/maps", maps.str());
+    std::vector<uint64_t> pagemap(40, 0);
+    for (int i = 8; i < 40; ++i) pagemap[i] = (1ULL << 63) | static_cast<uint64_t>(100 + i); // PFNs 108..139
+    pagemap[20] = 1ULL << 62;                                                                     // Swapped out
+    tree.write("/42/pagemap", std::string(reinterpret_cast<const char*>(pagemap.data()), pagemap.size() * sizeof(uint64_t)));
+    tree.write("/bitmap", std::string(64, '\0'));
+
+    WorkingSetEstimator estimator(tree.path("/bitmap"), tree.root());
+    assert(estimator.isSupported());
+    WorkingSetWindow window;
+    assert(estimator.begin(42, 15, window));
+    assert(window.pfns.size() == 15);
+
+    int fd = open(tree.path("/bitmap").c_str(), O_RDWR);
+    uint64_t words[3];
+    assert(pread(fd, words, sizeof(words), 0) == sizeof(words));
+    assert(words[1] == ((((1ULL << 12) - 1) << 52) & ~(1ULL << 56)) && words[2] == 0xF); // 116..131 but 120
+    words[1] &= ~(0xFULL << 52); // PFNs 116..119 accessed
+    assert(pwrite(fd, words, sizeof(words), 0) == sizeof(words));
+    close(fd);
+
+    WorkingSetEstimate estimate;
+    assert(estimator.finish(window, estimate));
+    assert(estimate.sampled_pages == 15);
+    assert(estimate.accessed_fraction == 4.0 / 15.0);
+    assert(estimate.working_set_kb == static_cast<unsigned long long>(4.0 / 15.0 * 15 * (page / 1024)));
+    assert(!WorkingSetEstimator(tree.path("/missing")).isSupported());
+    Logger::log("WorkingSetEstimator test passed");
+}
+
+int main() {
+    testStatmIsResident();
+    testParseSmapsRollup();
+    testIncrementalAccounting();
+    testBudgetCountsAttempts();
+    testWorkingSetOnFakeTree();
+    return 0;
+}
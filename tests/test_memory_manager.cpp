@@ -1,4 +1,5 @@
 #include "MemoryManager.h"
+#include "ProcessManager.h"
 #include "Logger.h"
 #include <cassert>
 
@@ -6,7 +7,14 @@ void testMemoryManager() {
     MemoryManager mm;
     SchedulerConfig config;
     config.memory_threshold_mb = 2048;
-    mm.monitorMemory(config);
+    config.reclaim_advice = "cold";
+    config.reclaim_trigger_percent = 0.0;
+    config.reclaim_budget_mb = 0;         // Runs the candidate pass without advising anything
+    config.proactive_reclaim_mb = 0;
+    config.memory_rollups_per_cycle = 16;
+    config.working_set_window_ms = 0;
+    ProcessManager pm;
+    mm.monitorMemory(config, pm.captureSnapshot());
     assert(mm.getSystemMemoryUsage() >= 0.0);
     Logger::log("MemoryManager test passed");
 }
@@ -0,0 +1,54 @@
+#include "PressureMonitor.h"
+#include "Logger.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <chrono>
+
+void testParse() {
+    const char text[] =
+        "some avg10=1.25 avg60=0.50 avg300=0.10 total=123456\n"
+        "full avg10=0.75 avg60=0.00 avg300=0.00 total=789\n";
+    PressureStats stats;
+    assert(PressureMonitor::parse(text, strlen(text), stats));
+    assert(std::fabs(stats.some.avg10 - 1.25) < 1e-9);
+    assert(std::fabs(stats.some.avg60 - 0.50) < 1e-9);
+    assert(stats.some.total_us == 123456);
+    assert(std::fabs(stats.full.avg10 - 0.75) < 1e-9);
+    assert(stats.full.total_us == 789);
+
+    const char cpu_only[] = "some avg10=0.00 avg60=0.00 avg300=0.00 total=42\n";
+    assert(PressureMonitor::parse(cpu_only, strlen(cpu_only), stats));
+    assert(stats.some.total_us == 42 && stats.full.total_us == 0);
+}
+
+void testWaitTimesOutAndWakes() {
+    PressureMonitor monitor;
+    if (!monitor.isSupported()) return;
+    PressureSnapshot snapshot;
+    assert(monitor.read(snapshot));
+    assert(snapshot.cpu.some.avg10 >= 0.0);
+
+    // A trigger no idle test box will hit: all of a 2s window stalled on memory.
+    assert(monitor.addTrigger(PressureResource::MEMORY, true, 1999000, 2000000));
+    assert(monitor.wait(50) == 0);
+
+    std::thread waker([&monitor] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        monitor.wake();
+    });
+    auto start = std::chrono::steady_clock::now();
+    assert(monitor.wait(10000) == PressureMonitor::WOKEN);
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    waker.join();
+    monitor.clearTriggers();
+    assert(!monitor.hasTriggers());
+}
+
+int main() {
+    testParse();
+    testWaitTimesOutAndWakes();
+    Logger::log("PressureMonitor test passed");
+    return 0;
+}
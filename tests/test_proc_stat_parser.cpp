@@ -0,0 +1,49 @@
+#include "ProcStatParser.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstring>
+#include <unistd.h>
+
+void testParseCommWithSpacesAndParens() {
+    const char line[] =
+        "4242 (my (odd) proc) S 1 4242 4242 0 -1 4194560 120 0 0 0 "
+        "350 125 0 0 20 0 3 0 98765 10485760 512 18446744073709551615 "
+        "1 1 0 0 0 0 0 0 0 0 0 0 17 5 0 0 0 0 0\n";
+    ProcStat stat;
+    assert(ProcStatParser::parse(line, sizeof(line) - 1, stat));
+    assert(stat.pid == 4242);
+    assert(strcmp(stat.comm, "my (odd) proc") == 0);
+    assert(stat.state == 'S');
+    assert(stat.ppid == 1);
+    assert(stat.tpgid == -1);
+    assert(stat.flags == 4194560u);
+    assert(stat.utime == 350);
+    assert(stat.stime == 125);
+    assert(stat.num_threads == 3);
+    assert(stat.starttime == 98765);
+    assert(stat.rss == 512);
+    assert(stat.processor == 5);
+    assert(stat.rt_priority == 0);
+    assert(stat.policy == 0);
+}
+
+void testRejectTruncatedLine() {
+    const char line[] = "17 (short) R 1 17 17 0 -1 0 0";
+    ProcStat stat;
+    assert(!ProcStatParser::parse(line, sizeof(line) - 1, stat));
+}
+
+void testReadSelf() {
+    ProcStat stat;
+    assert(ProcStatParser::read(getpid(), stat));
+    assert(stat.pid == getpid());
+    assert(stat.state == 'R');
+}
+
+int main() {
+    testParseCommWithSpacesAndParens();
+    testRejectTruncatedLine();
+    testReadSelf();
+    Logger::log("ProcStatParser test passed");
+    return 0;
+}
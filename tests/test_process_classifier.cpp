@@ -0,0 +1,106 @@
+#include "ProcessClassifier.h"
+#include "ProcessTable.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstring>
+#include <unistd.h>
+
+ProcStat makeStat(int pid, const char* comm) {
+    ProcStat stat;
+    memset(&stat, 0, sizeof(stat));
+    stat.pid = pid;
+    stat.ppid = 1;
+    stat.pgrp = pid;
+    stat.tpgid = -1;
+    strncpy(stat.comm, comm, sizeof(stat.comm) - 1);
+    return stat;
+}
+
+void testKernelAndSystem() {
+    ProcessClassifier classifier;
+    ProcStat kworker = makeStat(4000, "kworker/0:1");
+    kworker.flags = ProcessClassifier::PF_KTHREAD;
+    assert(classifier.classify(kworker, 0, "/") == ProcessClass::KERNEL);
+
+    ProcStat child_of_kthreadd = makeStat(4001, "ksoftirqd/0");
+    child_of_kthreadd.ppid = 2;
+    assert(classifier.classify(child_of_kthreadd, 0, "") == ProcessClass::KERNEL);
+
+    ProcStat daemon = makeStat(4002, "sshd");
+    assert(classifier.classify(daemon, 0, "/system.slice/ssh.service") == ProcessClass::SYSTEM);
+    assert(classifier.classify(daemon, 1000, "/system.slice/ssh.service") == ProcessClass::SYSTEM);
+
+    ProcStat self = makeStat(getpid(), "smart_scheduler");
+    assert(classifier.classify(self, 1000, "/user.slice") == ProcessClass::SYSTEM);
+}
+
+void testUserProcesses() {
+    ProcessClassifier classifier;
+    const std::string session = "/user.slice/user-1000.slice/session-2.scope";
+    ProcStat shell = makeStat(5000, "bash");
+    shell.tty_nr = 34816;
+    shell.tpgid = 5000;
+    assert(classifier.classify(shell, 1000, session) == ProcessClass::FOREGROUND);
+
+    ProcStat job = makeStat(5001, "make");
+    job.tty_nr = 34816;
+    job.tpgid = 5000;
+    assert(classifier.classify(job, 1000, session) == ProcessClass::BACKGROUND);
+
+    ProcStat editor = makeStat(5002, "code");
+    assert(classifier.classify(editor, 1000, "/user.slice/user-1000.slice/user@1000.service/app.slice/app-code.scope") ==
+           ProcessClass::FOREGROUND);
+    ProcStat indexer = makeStat(5003, "tracker-miner");
+    assert(classifier.classify(indexer, 1000, "/user.slice/user-1000.slice/user@1000.service/background.slice/tracker.service") ==
+           ProcessClass::BACKGROUND);
+    ProcStat agent = makeStat(5004, "gpg-agent");
+    assert(classifier.classify(agent, 1000, session) == ProcessClass::SESSION);
+
+    classifier.setExclusions({"pipewire", "Xorg"});
+    ProcStat audio = makeStat(5005, "pipewire");
+    assert(classifier.classify(audio, 1000, session) == ProcessClass::SYSTEM);
+}
+
+// `fg` and `bg` hand the terminal to another group without an exec.
+void testJobControlIsFollowed() {
+    ProcessClassifier classifier;
+    const std::string session = "/user.slice/user-1000.slice/session-2.scope";
+    ProcStat job = makeStat(5001, "make");
+    job.tty_nr = 34816;
+    job.tpgid = 5000;
+    ProcessClass cls = classifier.classify(job, 1000, session);
+    assert(cls == ProcessClass::BACKGROUND);
+    job.tpgid = 5001; // fg
+    cls = ProcessClassifier::jobControlClass(cls, job, session);
+    assert(cls == ProcessClass::FOREGROUND);
+    job.tpgid = 5000; // ^Z, bg
+    assert(ProcessClassifier::jobControlClass(cls, job, session) == ProcessClass::BACKGROUND);
+
+    // Classes the terminal did not decide stay as they are.
+    assert(ProcessClassifier::jobControlClass(ProcessClass::SYSTEM, job, session) == ProcessClass::SYSTEM);
+    assert(ProcessClassifier::jobControlClass(ProcessClass::SESSION, job, session) == ProcessClass::SESSION);
+    job.tpgid = 5001;
+    assert(ProcessClassifier::jobControlClass(ProcessClass::BACKGROUND, job, "/user.slice/background.slice/x.service") ==
+           ProcessClass::BACKGROUND);
+    ProcStat editor = makeStat(5002, "code");
+    assert(ProcessClassifier::jobControlClass(ProcessClass::FOREGROUND, editor, "/app.slice/app-code.scope") ==
+           ProcessClass::FOREGROUND);
+}
+
+void testTableClassifiesOnce() {
+    ProcessTable table;
+    table.scan();
+    ProcessEntry* self = table.find(getpid());
+    assert(self != nullptr);
+    assert(self->process_class == ProcessClass::SYSTEM);
+    assert(!ProcessClassifier::isActionable(self->process_class));
+}
+
+int main() {
+    testKernelAndSystem();
+    testUserProcesses();
+    testJobControlIsFollowed();
+    testTableClassifiesOnce();
+    Logger::log("ProcessClassifier test passed");
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include "ProcessManager.h"
+#include "ProcessTable.h"
+#include "ThreadSampler.h"
+#include "PidfdWatcher.h"
+#include "TaskstatsClient.h"
+#include "ProcStatParser.h"
+#include "Logger.h"
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <sys/syscall.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void testTableTracksLifetimes() {
+    ProcessTable table;
+    table.scan();
+    ProcessEntry* self = table.find(getpid());
+    assert(self != nullptr);
+    ProcessKey selfKey = self->key;
+    size_t selfSlot = static_cast<size_t>(self - table.entries().data());
+
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    table.scan();
+    assert(table.find(child) != nullptr);
+    // Slot is stable across scans; the slot vector itself may move.
+    ProcessEntry* again = table.find(selfKey);
+    assert(again != nullptr && again->key == selfKey);
+    assert(static_cast<size_t>(again - table.entries().data()) == selfSlot);
+
+    // An unreaped child stays in /proc as a zombie; it is gone for the
+    // table and must not be tracked again on the next scan.
+    kill(child, SIGKILL);
+    ProcStat stat;
+    while (ProcStatParser::read(child, stat) && stat.state != 'Z') std::this_thread::yield();
+    table.scan();
+    assert(table.find(child) == nullptr);
+    assert(table.exitedLastScan() >= 1);
+    table.scan();
+    assert(table.find(child) == nullptr);
+    waitpid(child, nullptr, 0);
+}
+
+void testIdentityIsCachedAndInterned() {
+    ProcessTable table;
+    table.scan();
+    ProcessEntry* self = table.find(getpid());
+    assert(self != nullptr && self->identity);
+    ProcStat stat;
+    assert(ProcStatParser::read(getpid(), stat));
+    assert(*self->identity->comm == stat.comm);
+    assert(!self->identity->exe->empty());
+    assert(self->identity->cmdline->find("test_process_manager") != std::string::npos);
+    assert(table.identities().find(self->key) == self->identity);
+    // Matching is by pointer: the same comm interns to the same string.
+    assert(table.identities().intern(stat.comm) == self->identity->comm);
+
+    ProcessKey key = self->key;
+    table.remove(getpid());
+    assert(!table.identities().find(key));
+}
+
+void testQuietProcessesAreSampledLess() {
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    ProcessTable table;
+    SamplingPolicy policy;
+    policy.warm_interval = 4;
+    policy.idle_interval = 50;
+    table.setSamplingPolicy(policy);
+    table.scan(); // First scan reads everything
+    assert(table.sampledLastScan() == table.size());
+    ProcessEntry* sleeper = table.find(child);
+    for (int i = 0; i < 40 && sleeper->tier != SamplingTier::IDLE; ++i) {
+        table.scan();
+        sleeper = table.find(child);
+    }
+    assert(sleeper->tier == SamplingTier::IDLE);
+
+    // Past its interval the sleeper is still seen every scan but read at
+    // most once in ten. Identity checks count as reads, and across the
+    // scans that skip it the table is read far less than in full.
+    auto sampled_at = sleeper->sampled_at;
+    size_t skipped = 0;
+    size_t reads = 0;
+    size_t listed = 0;
+    for (int i = 0; i < 10; ++i) {
+        table.scan();
+        sleeper = table.find(child);
+        assert(sleeper != nullptr && sleeper->generation == table.find(getpid())->generation);
+        if (sleeper->sampled_at == sampled_at) {
+            ++skipped;
+            reads += table.sampledLastScan();
+            listed += table.size();
+        }
+        sampled_at = sleeper->sampled_at;
+    }
+    assert(skipped >= 5); // Misses only the scans a wakeup check forced to read everything
+    assert(reads * 2 < listed);
+
+    // A skipped PID that now belongs to another process is read in full
+    // once its identity check comes round.
+    unsigned long long starttime = sleeper->key.starttime;
+    sleeper->key.starttime = starttime + 1;
+    for (unsigned int i = 0; i < policy.warm_interval; ++i) {
+        table.scan();
+        sleeper = table.find(child);
+        if (sleeper->key.starttime == starttime) break;
+    }
+    assert(sleeper != nullptr && sleeper->key.starttime == starttime);
+    assert(sleeper->tier == SamplingTier::HOT);
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    table.scan();
+    assert(table.find(child) == nullptr); // Exit is caught from the listing
+}
+
+void testPidfdWatcherReportsExit() {
+    if (!PidfdWatcher::isSupported()) return;
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    ProcStat stat;
+    assert(ProcStatParser::read(child, stat));
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    int exited_pid = 0;
+    PidfdWatcher watcher;
+    assert(watcher.start([&](int pid, unsigned long long) {
+        std::lock_guard<std::mutex> lock(mtx);
+        exited_pid = pid;
+        cv.notify_all();
+    }));
+    assert(!watcher.watch(child, stat.starttime + 1)); // Wrong identity is refused
+    assert(!watcher.sendSignal(ProcessKey{child, stat.starttime + 1}, SIGCONT)); // Unwatched, wrong identity
+    assert(watcher.watch(child, stat.starttime));
+    assert(!watcher.sendSignal(ProcessKey{child, stat.starttime + 1}, SIGCONT)); // Watched, wrong identity
+    assert(watcher.sendSignal(ProcessKey{child, stat.starttime}, SIGKILL));
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        assert(cv.wait_for(lock, std::chrono::seconds(5), [&] { return exited_pid == child; }));
+    }
+    assert(!watcher.isWatched(child));
+    waitpid(child, nullptr, 0);
+    assert(!watcher.sendSignal(ProcessKey{child, stat.starttime}, SIGKILL)); // Reaped; nothing to signal
+    watcher.stop();
+}
+
+void testTaskstatsRefresh() {
+    if (!TaskstatsClient::isSupported()) return; // Needs CAP_NET_ADMIN
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    ProcessTable table;
+    table.setReaderBackend(ProcReaderBackend::TASKSTATS);
+    table.scan();
+    assert(table.find(child) != nullptr);
+    table.refresh(); // Switches the counter source, so only a new baseline
+    ProcessEntry* self = table.find(getpid());
+    assert(self != nullptr && self->counters_only);
+
+    volatile unsigned long spin = 0;
+    for (unsigned long i = 0; i < 200000000UL; ++i) spin += i;
+    table.refresh();
+    self = table.find(getpid());
+    assert(self->cpu_usage > 10.0);
+
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    table.refresh(); // Exit record or a failed query releases the slot
+    assert(table.find(child) == nullptr);
+}
+
+void testSnapshotReportsIntervalCPU() {
+    ProcessManager pm;
+    pm.captureSnapshot();
+    volatile unsigned long spin = 0;
+    for (unsigned long i = 0; i < 200000000UL; ++i) spin += i;
+    ProcessSnapshot snapshot = pm.captureSnapshot();
+    ProcessInfo self;
+    assert(snapshot.find(getpid(), self));
+    assert(self.cpu_usage > 10.0); // Busy over the interval, not lifetime seconds
+}
+
+// Rows keep table order; lookups go through the pid index.
+void testSnapshotIndexOf() {
+    ProcessSnapshot::Builder builder;
+    for (int pid : {300, 7, 4100, 12, 1}) {
+        ProcessInfo info = ProcessInfo();
+        info.pid = pid;
+        builder.add(info);
+    }
+    ProcessSnapshot snapshot = builder.build(std::chrono::steady_clock::now());
+    for (size_t row = 0; row < snapshot.size(); ++row) assert(snapshot.indexOf(snapshot.pids()[row]) == row);
+    assert(snapshot.indexOf(8) == ProcessSnapshot::npos);
+    assert(snapshot.indexOf(5000) == ProcessSnapshot::npos);
+    assert(ProcessSnapshot().indexOf(1) == ProcessSnapshot::npos);
+}
+
+void testSchedstatIsParsed() {
+    ProcSample sample = ProcSample();
+    const char line[] = "2053462 118903 51\n";
+    assert(ProcScanner::parseSchedstat(line, sizeof(line) - 1, sample));
+    assert(sample.has_schedstat);
+    assert(sample.run_ns == 2053462 && sample.wait_ns == 118903 && sample.timeslices == 51);
+    assert(!ProcScanner::parseSchedstat("12 34\n", 6, sample)); // Truncated
+    assert(!sample.has_schedstat);
+
+    // Any kernel with CONFIG_SCHED_INFO has the per-PID file.
+    ProcessTable table;
+    table.scan();
+    ProcessEntry* self = table.find(getpid());
+    assert(self != nullptr);
+    if (!self->has_schedstat) return;
+    assert(self->run_ns > 0 && self->timeslices > 0);
+}
+
+void testThreadSamplerFindsHotThread() {
+    std::atomic<bool> stop(false);
+    std::atomic<int> spinner_tid(0);
+    std::thread spinner([&] {
+        spinner_tid = static_cast<int>(syscall(SYS_gettid));
+        volatile unsigned long spin = 0;
+        while (!stop) spin++;
+    });
+    while (spinner_tid == 0) std::this_thread::yield();
+
+    ThreadSampler sampler;
+    std::vector<ThreadSample> threads;
+    sampler.sample(getpid(), threads);
+    assert(threads.size() >= 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double total = sampler.sample(getpid(), threads);
+    stop = true;
+    spinner.join();
+
+    double spinner_usage = 0.0;
+    for (const auto& thread : threads) {
+        if (thread.tid == spinner_tid) spinner_usage = thread.cpu_usage;
+    }
+    assert(spinner_usage > 20.0);
+    assert(total >= spinner_usage);
+}
+
+int main() {
+    testTableTracksLifetimes();
+    testIdentityIsCachedAndInterned();
+    testQuietProcessesAreSampledLess();
+    testPidfdWatcherReportsExit();
+    testTaskstatsRefresh();
+    testSnapshotReportsIntervalCPU();
+    testSnapshotIndexOf();
+    testSchedstatIsParsed();
+    testThreadSamplerFindsHotThread();
+    Logger::log("ProcessManager test passed");
+    return 0;
+}
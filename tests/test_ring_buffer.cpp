@@ -0,0 +1,85 @@
+#include "RingBuffer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <random>
+
+bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-6;
+}
+
+void testWindowAndStatistics() {
+    RingBuffer<double, 4> buffer(0.5);
+    assert(buffer.empty());
+    assert(buffer.mean() == 0.0);
+    for (double value : {1.0, 5.0, 3.0}) buffer.push(value);
+    assert(buffer.size() == 3 && !buffer.full());
+    assert(near(buffer.sum(), 9.0));
+    assert(near(buffer.mean(), 3.0));
+    assert(near(buffer.variance(), 8.0 / 3.0));
+    assert(buffer.min() == 1.0 && buffer.max() == 5.0);
+    assert(near(buffer.ewma(), 0.5 * 3.0 + 0.5 * (0.5 * 5.0 + 0.5 * 1.0)));
+
+    buffer.push(2.0);
+    buffer.push(4.0); // Evicts 1.0
+    assert(buffer.full() && buffer.size() == 4);
+    assert(buffer[0] == 5.0 && buffer[3] == 4.0 && buffer.newest() == 4.0);
+    assert(near(buffer.sum(), 14.0));
+    assert(buffer.min() == 2.0 && buffer.max() == 5.0);
+    buffer.push(3.0); // Evicts the maximum
+    assert(buffer.max() == 4.0);
+
+    double out[4];
+    assert(buffer.copyTo(out) == 4);
+    assert(out[0] == 3.0 && out[1] == 2.0 && out[2] == 4.0 && out[3] == 3.0);
+    assert(buffer.snapshot() == std::vector<double>({3.0, 2.0, 4.0, 3.0}));
+
+    buffer.clear();
+    assert(buffer.empty() && buffer.snapshot().empty());
+    buffer.push(7.0);
+    assert(buffer.min() == 7.0 && buffer.max() == 7.0 && buffer.ewma() == 7.0);
+    Logger::log("RingBuffer window test passed");
+}
+
+// Checks every statistic against a recomputation over a plain deque.
+void testAgainstReference() {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> value(-50, 50);
+    RingBuffer<int, 13> buffer;
+    std::deque<int> reference;
+    for (int i = 0; i < 5000; ++i) {
+        int v = value(rng);
+        buffer.push(v);
+        reference.push_back(v);
+        if (reference.size() > 13) reference.pop_front();
+        assert(buffer.size() == reference.size());
+        assert(buffer.min() == *std::min_element(reference.begin(), reference.end()));
+        assert(buffer.max() == *std::max_element(reference.begin(), reference.end()));
+        assert(near(buffer.sum(), std::accumulate(reference.begin(), reference.end(), 0.0)));
+        std::vector<int> window = buffer.snapshot();
+        assert(std::equal(window.begin(), window.end(), reference.begin()));
+    }
+    Logger::log("RingBuffer reference test passed");
+}
+
+// Long runs of floating-point values must not drift from the true sum.
+void testNoDrift() {
+    RingBuffer<double, 100> buffer;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> value(0.0, 1e6);
+    for (int i = 0; i < 100000; ++i) buffer.push(value(rng));
+    std::vector<double> window = buffer.snapshot();
+    double sum = std::accumulate(window.begin(), window.end(), 0.0);
+    assert(std::fabs(buffer.sum() - sum) < 1e-6 * sum);
+    Logger::log("RingBuffer drift test passed");
+}
+
+int main() {
+    testWindowAndStatistics();
+    testAgainstReference();
+    testNoDrift();
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "SchedStatSampler.h"
+#include "Logger.h"
+#include <cassert>
+#include <cmath>
+#include <string>
+
+bool near(double a, double b, double tolerance) {
+    return std::fabs(a - b) < tolerance;
+}
+
+std::string schedstat(unsigned long long wait0, unsigned long long slices0, unsigned long long wait1,
+                      unsigned long long slices1) {
+    return "version 15\ntimestamp 4295000000\n"
+           "cpu0 0 0 100 50 60 30 900000000 " + std::to_string(wait0) + " " + std::to_string(slices0) + "\n"
+           "domain0 00000003 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32\n"
+           "cpu1 0 0 80 40 50 20 700000000 " + std::to_string(wait1) + " " + std::to_string(slices1) + "\n"
+           "domain0 00000003 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32\n";
+}
+
+// Wait deltas become ms of waiting per second, per CPU and summed.
+void testRatesFromDeltas() {
+    SchedStatSampler sampler;
+    SchedStatSnapshot snapshot;
+    std::string first = schedstat(1000000000ULL, 1000, 2000000000ULL, 2000);
+    assert(sampler.update(first.data(), first.size(), 0.0, snapshot));
+    assert(snapshot.since_boot);
+    assert(snapshot.cores.size() == 2 && snapshot.total.wait_rate == 0.0);
+
+    // Over 0.5s: cpu0 waited 100ms over 50 slices, cpu1 waited 25ms over 25.
+    std::string second = schedstat(1100000000ULL, 1050, 2025000000ULL, 2025);
+    assert(sampler.update(second.data(), second.size(), 0.5, snapshot));
+    assert(!snapshot.since_boot);
+    assert(near(snapshot.cores[0].wait_rate, 200.0, 1e-9));
+    assert(near(snapshot.cores[0].latency_us, 2000.0, 1e-9));
+    assert(near(snapshot.cores[1].wait_rate, 50.0, 1e-9));
+    assert(near(snapshot.total.wait_rate, 250.0, 1e-9));
+    assert(near(snapshot.total.latency_us, 125000.0 / 75.0, 1e-9));
+    assert(near(snapshot.max_wait_rate, 200.0, 1e-9));
+    Logger::log("SchedStatSampler rate test passed");
+}
+
+// A CPU missing from a sample is reported offline; when it returns with
+// reset counters the interval shows no negative time.
+void testOfflineCpu() {
+    SchedStatSampler sampler;
+    SchedStatSnapshot snapshot;
+    std::string both = schedstat(1000000000ULL, 1000, 2000000000ULL, 2000);
+    sampler.update(both.data(), both.size(), 0.0, snapshot);
+    std::string only_cpu0 = "version 15\ncpu0 0 0 0 0 0 0 0 1010000000 1010\n";
+    assert(sampler.update(only_cpu0.data(), only_cpu0.size(), 1.0, snapshot));
+    assert(snapshot.cores[0].online && !snapshot.cores[1].online);
+    assert(near(snapshot.total.wait_rate, 10.0, 1e-9));
+
+    std::string reset = schedstat(1020000000ULL, 1020, 1000, 1);
+    assert(sampler.update(reset.data(), reset.size(), 1.0, snapshot));
+    assert(snapshot.cores[1].online && snapshot.cores[1].wait_rate == 0.0);
+    assert(near(snapshot.total.wait_rate, 10.0, 1e-9));
+
+    assert(!sampler.update("version 15\n", 11, 1.0, snapshot)); // No cpu lines
+    Logger::log("SchedStatSampler offline test passed");
+}
+
+void testLiveSample() {
+    SchedStatSampler sampler;
+    if (!sampler.isSupported()) return; // Needs CONFIG_SCHEDSTATS
+    SchedStatSnapshot snapshot;
+    assert(sampler.sample(snapshot) && snapshot.since_boot);
+    assert(sampler.sample(snapshot) && !snapshot.since_boot);
+    assert(snapshot.total.wait_rate >= 0.0);
+}
+
+int main() {
+    testRatesFromDeltas();
+    testOfflineCpu();
+    testLiveSample();
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "SystemSampler.h"
+#include "SystemMonitor.h"
+#include "SeqLock.h"
+#include "Logger.h"
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+struct Payload {
+    unsigned long long values[32];
+};
+
+// A reader must never see a mix of two stores.
+void testSeqLockConsistency() {
+    SeqLock<Payload> lock;
+    Payload read;
+    assert(!lock.load(read));
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        Payload value;
+        for (unsigned long long i = 1; i <= 200000; ++i) {
+            for (auto& v : value.values) v = i;
+            lock.store(value);
+        }
+        done = true;
+    });
+    unsigned long long last = 0;
+    size_t reads = 0;
+    while (!done || reads == 0) {
+        if (!lock.load(read)) continue;
+        for (auto v : read.values) assert(v == read.values[0]);
+        assert(read.values[0] >= last); // Never goes back in time
+        last = read.values[0];
+        ++reads;
+    }
+    writer.join();
+    assert(lock.load(read) && read.values[0] == 200000);
+    assert(lock.version() == 200000);
+    Logger::log("SeqLock consistency test passed");
+}
+
+void testSamplerPublishes() {
+    SystemSampler sampler;
+    SystemSample sample;
+    assert(!sampler.latest(sample));
+    sampler.start(1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    assert(sampler.latest(sample));
+    assert(sample.sequence > 50); // Loose: CI machines oversleep
+    assert(sample.cpu_busy_avg >= 0.0 && sample.cpu_busy_avg <= 100.0);
+    assert(sample.memory.total > 0);
+    assert(sample.online_cpus > 0);
+
+    SystemMonitor monitor;
+    monitor.attach(&sampler);
+    double usage = monitor.getSystemCPUUsage();
+    assert(usage >= 0.0 && usage <= 100.0);
+    assert(monitor.getSystemMemoryUsage() > 0.0);
+
+    sampler.setRate(10);
+    SystemSample before, after;
+    assert(sampler.latest(before));
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    assert(sampler.latest(after));
+    assert(after.sequence - before.sequence < 10);
+    sampler.stop();
+    assert(!sampler.isRunning());
+    Logger::log("SystemSampler publish test passed");
+}
+
+// At 1 kHz most /proc/stat reads land between two jiffies and come back
+// identical; they must not pull the average towards idle.
+void testIdenticalStatImagesKeepAverage() {
+    static const char FIRST[] = "cpu  1000 0 500 8000 100 0 0 0 0 0\ncpu0 1000 0 500 8000 100 0 0 0 0 0\n";
+    static const char BUSY[] = "cpu  1160 0 540 8100 100 0 0 0 0 0\ncpu0 1160 0 540 8100 100 0 0 0 0 0\n";
+    static const char IDLE[] = "cpu  1160 0 540 8200 100 0 0 0 0 0\ncpu0 1160 0 540 8200 100 0 0 0 0 0\n";
+    SystemSampler sampler;
+    CpuStatSampler stat;
+    CpuStatSnapshot cpu;
+    SystemSample sample = SystemSample();
+    assert(stat.update(FIRST, strlen(FIRST), 0.0, cpu));
+    sampler.update(cpu, sample);
+    ++sample.sequence;
+    assert(stat.update(BUSY, strlen(BUSY), 1.0, cpu));
+    assert(cpu.jiffies == 300);
+    sampler.update(cpu, sample);
+    ++sample.sequence;
+    double average = sample.cpu_busy_avg;
+    assert(average > 50.0);
+
+    for (int i = 0; i < 250; ++i) {
+        assert(stat.update(BUSY, strlen(BUSY), 0.001, cpu));
+        assert(cpu.jiffies == 0);
+        sampler.update(cpu, sample);
+        ++sample.sequence;
+    }
+    assert(sample.cpu_busy_avg == average);
+    assert(std::fabs(sample.cpu.busy - 200.0 / 3.0) < 1e-6);
+
+    // The next tick is weighted by all 250ms since the last one.
+    assert(stat.update(IDLE, strlen(IDLE), 0.001, cpu));
+    sampler.update(cpu, sample);
+    assert(sample.cpu.busy == 0.0);
+    assert(std::fabs(sample.cpu_busy_avg - average * std::exp(-(0.25 + 0.001) / 0.25)) < 1e-6);
+    Logger::log("SystemSampler identical /proc/stat test passed");
+}
+
+int main() {
+    testSeqLockConsistency();
+    testIdenticalStatImagesKeepAverage();
+    testSamplerPublishes();
+    return 0;
+}